@@ -0,0 +1,69 @@
+/**
+ * @file BakedPatterns.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Effects stored as one period of palette indexed pixels in flash.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The candy cane, flag and train are each a pure function of their position,
+ * so rather than compute them every step they keep one period of pattern, two
+ * bits per pixel indexing a four colour palette, and each frame is a single
+ * expand of that at the current position.  The indices are laid out four to
+ * a byte, pixel 0 in the low bits, so an animation authored elsewhere can be
+ * pasted in as a byte array just as well as baked by the helpers below.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "IndexedFrame.h"
+
+#define BAKED_PALETTE_SIZE 4
+#define BAKED_INDEX_BYTES(length) (((length) + 3) / 4)
+
+/** How the pattern moves with its position. */
+enum BakedMode : uint8_t {
+  BAKED_ROTATE,     // the pattern repeats along the string, shifted one pixel per step
+  BAKED_SLIDE,      // the pattern appears once on palette[0] and slides off the end
+};
+
+struct BakedPattern {
+  BakedMode mode;
+  uint16_t length;                // pixels in the pattern
+  const uint8_t *indices;         // BAKED_INDEX_BYTES(length) bytes, 2 bits per pixel
+  const CRGB *palette;            // BAKED_PALETTE_SIZE colours
+};
+
+/** Draw the pattern at a position, which is the phase of a BAKED_ROTATE
+ * pattern (less than length), or the first pixel of a BAKED_SLIDE one.
+ */
+void renderBakedPattern(CRGB *leds, uint16_t nbrLEDS, const BakedPattern &pattern, uint16_t position);
+
+/** The same into an indexed frame, whose first BAKED_PALETTE_SIZE palette entries are set from the pattern's. */
+void renderBakedPattern(IndexedFrame &frame, uint16_t nbrLEDS, const BakedPattern &pattern, uint16_t position);
+
+/** The most power, unscaled (see PowerTelemetry.h), the pattern draws on
+ * nbrLEDS pixels at any position.  A BAKED_ROTATE pattern on a whole number
+ * of its periods draws the same at every phase.
+ */
+uint32_t bakedPatternPower_mW(const BakedPattern &pattern, uint16_t nbrLEDS);
+
+/** The position for the pattern's next step, with the same motion as the live effects. */
+uint16_t nextBakedPosition(const BakedPattern &pattern, uint16_t position, uint16_t nbrLEDS);
+
+/** Packed indices as a literal type, so they can be baked at compile time. */
+template <uint16_t LENGTH> struct BakedIndices {
+  uint8_t bytes[BAKED_INDEX_BYTES(LENGTH)];
+};
+
+/** Stripes stripeWidth pixels wide using palette entries firstColor, firstColor + 1, ... */
+template <uint16_t LENGTH> constexpr BakedIndices<LENGTH> bakeStripes(uint8_t stripeWidth, uint8_t firstColor = 0) {
+  BakedIndices<LENGTH> baked {};
+  for (uint16_t i = 0; i < LENGTH; i++)
+    baked.bytes[i >> 2] |= ((firstColor + i / stripeWidth) & 3) << ((i & 3) * 2);
+  return baked;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file Benchmark.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief On-target cycle counts for the effects and the show path.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Built with the nano_33_iot_bench environment.  The controller then skips
+ * the network altogether and prints a table over Serial of the cycles every
+ * registered effect takes to render a step and the frame takes to show,
+ * repeated every BENCHMARK_REPEAT_s.
+ *
+ * The Cortex-M0+ has no DWT cycle counter, so cycles are counted from
+ * SysTick, which the core already runs at one reload per millisecond.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef BENCHMARK_MODE
+#define BENCHMARK_MODE 0
+#endif
+
+#define BENCHMARK_FRAMES 200            // steps timed per effect
+#define BENCHMARK_SEED 1
+#define BENCHMARK_REPEAT_s 10
+
+/** Print a line of a benchmark report.  Reports go out straight away, they
+ * never run alongside the show; it's the one place output doesn't go through
+ * the event log.
+ */
+#define BENCHMARK_PRINTF_SIZE 256
+#define BENCHMARK_PRINTF(...) \
+{ \
+  static char _line[BENCHMARK_PRINTF_SIZE]; \
+  snprintf(_line, sizeof(_line), __VA_ARGS__); \
+  Serial.print(_line); \
+}
+
+/** Cycles since start up, wrapping every 2^32 cycles (89 s at 48 MHz). */
+uint32_t cycleCount();
+
+/** Time every effect and the show path and print the results. */
+void runBenchmarks();
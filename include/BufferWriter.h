@@ -0,0 +1,47 @@
+/**
+ * @file BufferWriter.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Text output into a fixed buffer, without printf or the heap.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Numbers are formatted by subtracting powers of ten rather than dividing,
+ * the M0+ has no divide instruction.  Anything past the end of the buffer is
+ * dropped and remembered, so a caller can check overflowed() once at the end.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class BufferWriter {
+
+  public:
+    BufferWriter(char *buffer, uint16_t size) : _buffer(buffer), _size(size) {}
+
+    BufferWriter &append(const char *text);
+    BufferWriter &append(const char *text, uint16_t length);
+    BufferWriter &append(char c);
+    BufferWriter &append(uint32_t value);
+    BufferWriter &append(int32_t value);
+    BufferWriter &append(uint64_t value);
+
+    /** A JSON string, quoted and with quotes, backslashes and control characters escaped. */
+    BufferWriter &appendJsonString(const char *text);
+
+    const char *data() const { return _buffer; }
+    uint16_t length() const { return _length; }
+
+    /** True if anything was dropped for want of room. */
+    bool overflowed() const { return _overflowed; }
+
+    void clear() { _length = 0; _overflowed = false; }
+
+  private:
+    char *_buffer;
+    uint16_t _size;
+    uint16_t _length = 0;
+    bool _overflowed = false;
+};
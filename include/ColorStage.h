@@ -0,0 +1,76 @@
+/**
+ * @file ColorStage.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Gamma, brightness and temporal dithering on the way out to the string.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Effects draw in perceptual colour at full scale.  On the way to the string
+ * each channel goes through the LED_GAMMA curve and the frame's brightness.
+ * The curve is a 16 bit table built at compile time.  Brightness moves with
+ * the power limiter, so it is folded in at run time, and only when it changes,
+ * into a pair of 256 byte tables: the 8 bit level sent to the string and the
+ * fraction of a level left over.
+ *
+ * With LED_DITHER the fraction isn't thrown away.  Each frame sent compares
+ * it with a threshold that steps through all 256 values in bit reversed order,
+ * so a channel 0.25 above a level spends a quarter of the frames one level
+ * up, evenly spread.  Each pixel and channel starts the sequence at a
+ * different point so neighbouring pixels don't flicker together.  Dithering
+ * needs frames sent at DITHER_FRAMES_PER_SECOND or it becomes visible.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "XmasLights.h"
+
+#define COLOR_STAGE_LEVELS 256
+#define DITHER_PIXEL_STEP 151           // threshold offset between neighbouring pixels, odd so all are used
+
+class ColorStage {
+
+  public:
+    /** Use brightness for the frames that follow, rebuilding the tables if it changed. */
+    void setBrightness(uint8_t brightness);
+
+    /** Move the dither on, once for every frame sent. */
+    void nextFrame();
+
+    /** One channel of a pixel, corrected.  channel is 0-2 in any order, for the dither offset. */
+    uint8_t correct(uint8_t value, uint16_t pixel, uint8_t channel) const {
+#if LED_DITHER
+      uint8_t threshold = _threshold + (uint8_t)(pixel * DITHER_PIXEL_STEP) + channel * 85;
+      return _level[value] + (_fraction[value] > threshold);
+#else
+      (void)pixel;
+      (void)channel;
+      return _level[value];
+#endif
+    }
+
+    /** A channel without dithering, for colours shared by many pixels. */
+    uint8_t correct(uint8_t value) const { return _level[value]; }
+
+    /** Correct n pixels from in to out, which may be the same buffer. */
+    void correct(const CRGB *in, CRGB *out, uint16_t n, uint16_t firstPixel = 0) const;
+
+  private:
+    bool _built = false;
+    uint8_t _brightness = 0;
+    uint8_t _frame = 0;
+    uint8_t _threshold = 0;
+    uint8_t _level[COLOR_STAGE_LEVELS];
+    uint8_t _fraction[COLOR_STAGE_LEVELS];     // 256ths of a level over _level
+};
+
+extern ColorStage colorStage;
+
+/** The LED_GAMMA curve, each level's light at full brightness as 0-65535.
+ * What the power estimate costs, the LEDs draw for the light they give.
+ */
+extern const uint16_t *const gammaCurve;
@@ -0,0 +1,92 @@
+/**
+ * @file Effects.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The light effects and the registry used to run them.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every effect is an entry in a table giving its name, a hook to reset its
+ * state, the function that draws its next step and how often that step is
+ * due.  Adding or removing an effect is only a change to the table.
+ *
+ * Each effect also has a renderer for the indexed frame buffer, used when it
+ * is built with LED_INDEXED_FRAME.  Those set the frame's palette as well as
+ * its pixels every step.
+ *
+ * An effect can also give a power model, the most power any of its steps
+ * draws.  It's worked out once each time the effect is selected, and frames
+ * the effect draws are then limited by it rather than costed pixel by pixel
+ * (see PowerTelemetry.h).  Only effects whose power is known from their
+ * pattern have one - the candy cane, flag and train.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "IndexedFrame.h"
+
+#define EFFECT_MAX_CATCHUP_STEPS 3      // most late steps drawn in one frame to stay on the show clock
+
+/** A registered effect. */
+struct Effect {
+  const char *name;
+  void (*reset)();                                  // put the effect back to its first step
+  void (*render)(CRGB *leds, uint16_t nbrLEDS);     // draw the next step over the previous frame
+  void (*renderIndexed)(IndexedFrame &frame, uint16_t nbrLEDS);   // the same into an indexed frame
+  uint16_t frameInterval_ms;                        // time between steps
+  uint32_t (*power_mW)(uint16_t nbrLEDS);           // most unscaled power a step draws, NULL without a model
+};
+
+extern int currentEffectNbr;
+
+uint8_t effectCount();
+const Effect &getEffect(uint8_t effectNbr);
+const Effect &currentEffect();
+
+/** Make an effect current, resetting its state and clearing the frame. */
+void selectEffect(uint8_t effectNbr);
+
+/** Move on to the next effect in the table. */
+void nextEffect();
+
+/** Make an effect current, crossfading to it over EFFECT_TRANSITION_ms.
+ *
+ * The outgoing effect carries on from frame, which becomes its own, and
+ * both step on their own schedules until the transition is over.  The two are
+ * blended as the frame is published (see transitionFrame()), so only one
+ * extra frame is needed.  Indexed frames just cut to the new effect.
+ */
+void transitionToEffect(uint8_t effectNbr, const CRGB *frame, uint16_t nbrLEDS);
+void transitionToEffect(uint8_t effectNbr, const IndexedFrame &frame);
+
+/** Drop the outgoing effect, finishing any transition at once.
+ *
+ * Transitions are only moved on by renderEffect(), so anything that takes
+ * over the frame from the effects has to end them itself.
+ */
+void endTransition();
+
+/** The outgoing effect's frame while a transition is running, otherwise NULL. */
+const CRGB *transitionFrame();
+
+/** How far the transition has got, 0-256 for the weight of the incoming effect. */
+uint16_t transitionWeight();
+
+/** The most unscaled power the frame being drawn can take by the effects'
+ * power models.  Mid transition, the larger of the two effects', a blend of
+ * two frames never draws more than the brighter of them.
+ *
+ * @returns 0 if an effect showing has no model.
+ */
+uint32_t effectPower_mW();
+
+/** Draw the current effect's steps that are due by the show clock into leds.
+ *
+ * @returns true if the frame was changed.
+ */
+bool renderEffect(CRGB *leds, uint16_t nbrLEDS);
+bool renderEffect(IndexedFrame &frame, uint16_t nbrLEDS);
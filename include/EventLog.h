@@ -0,0 +1,96 @@
+/**
+ * @file EventLog.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Binary event log, recorded anywhere and written out in idle time.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Logging an event only stores a 16 byte record - the time, the event and two
+ * integer arguments - in a static ring, so it can be left on in the frame
+ * path.  The ring is drained by a background task, as text to Serial, or with
+ * LOG_UDP as the records themselves broadcast to LOG_UDP_PORT for a collector
+ * to decode against the table in EventLog.cpp.  Serial is only written as
+ * far as it has room, and only a few lines at a time, the log never waits on
+ * it.  Each drain fits in TASK_LOG_SLICE_us.
+ *
+ * Each event has a shortest interval between records.  Those logged sooner
+ * are only counted, and the count goes out with the next record kept, so a
+ * burst costs one record rather than filling the ring.  Records logged with
+ * the ring full are dropped and counted.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiNINA.h>
+
+#define LOG_RECORDS 64                  // 1 KB of ring
+#define LOG_LINE_SIZE 64                // longest line written to Serial
+#define LOG_UDP_PORT 5570
+#define LOG_SERIAL_LINES 2              // most lines written to Serial in one call
+#define LOG_UDP_RECORDS 16              // most records in one datagram, a 268 byte write to the NINA
+
+/** 0 drains the log to Serial as text, 1 broadcasts the records over UDP once Wi-Fi is up. */
+#ifndef LOG_UDP
+#define LOG_UDP 0
+#endif
+
+/** Everything that can be logged, in the order of the table in EventLog.cpp. */
+enum LogEvent : uint8_t {
+  LOG_STARTED,                // pixels, strings
+  LOG_WIFI_CONNECTING,        // failed attempts so far
+  LOG_WIFI_CONNECTED,         // IP address, RSSI
+  LOG_WIFI_FAILED,            // retry in ms
+  LOG_WIFI_LOST,
+  LOG_FRAME_OVERRUN,          // frame us, frame period us
+  LOG_STREAM_STARTED,
+  LOG_STREAM_STOPPED,         // packets, lost packets
+  LOG_CLOCK_STEPPED,          // error ms
+  LOG_SETTINGS_SAVED,         // save number
+  NBR_OF_LOG_EVENTS
+};
+
+/** One logged event, as stored and as sent over UDP. */
+struct LogRecord {
+  uint32_t time_ms;
+  LogEvent event;
+  uint8_t reserved;
+  uint16_t suppressed;        // records of this event left out since the last one kept
+  int32_t arg0;
+  int32_t arg1;
+};
+
+class EventLog {
+
+  public:
+    /** Record an event, unless it's too soon after the last of its kind. */
+    void log(LogEvent event, int32_t arg0 = 0, int32_t arg1 = 0);
+
+    /** Write out up to LOG_SERIAL_LINES, as far as Serial has room for them. */
+    void drainToSerial();
+
+    /** Broadcast the records waiting in one datagram, no more than one per call. */
+    void drainToUdp(WiFiUDP &udp, IPAddress broadcast);
+
+    uint32_t logged() const { return _logged; }
+    uint32_t suppressed() const { return _suppressed; }
+    uint32_t dropped() const { return _dropped; }
+
+  private:
+    LogRecord _ring[LOG_RECORDS];
+    uint8_t _head = 0;                        // next record to write
+    uint8_t _tail = 0;                        // next record to drain
+    uint8_t _count = 0;
+    uint32_t _last_ms[NBR_OF_LOG_EVENTS] = {};
+    uint16_t _pending[NBR_OF_LOG_EVENTS] = {}; // suppressed since the last record kept
+    bool _everLogged[NBR_OF_LOG_EVENTS] = {};
+    uint32_t _logged = 0;
+    uint32_t _suppressed = 0;
+    uint32_t _dropped = 0;
+
+    void formatRecord(char *line, size_t size, const LogRecord &record);
+};
+
+extern EventLog eventLog;
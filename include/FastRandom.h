@@ -0,0 +1,72 @@
+/**
+ * @file FastRandom.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Cheap random numbers for the per pixel effects.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Arduino random(n) goes through libc rand() and a modulo, both slow on the
+ * SAMD21.  This is an xorshift32 generator that hands out its 32 bits a few
+ * at a time, so a coin flip costs one bit and a small range costs eight.
+ * Ranges are mapped with a multiply and shift rather than a %.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class FastRandom {
+
+  public:
+    FastRandom(uint32_t seed = 1) { setSeed(seed); }
+
+    /** Restart the sequence, the same seed always gives the same numbers.
+     * 0 is not a valid xorshift state and is replaced by 1.
+     */
+    void setSeed(uint32_t seed) {
+      _state = seed ? seed : 1;
+      _pool = 0;
+      _poolBits = 0;
+    }
+
+    /** Seed from ADC noise and the time since reset, for a different show each boot. */
+    void seedFromNoise();
+
+    /** A fresh 32 random bits, bypassing the pool. */
+    uint32_t next32() {
+      _state ^= _state << 13;
+      _state ^= _state >> 17;
+      _state ^= _state << 5;
+      return _state;
+    }
+
+    /** nbrBits (1 - 32) random bits from the pool, refilling it as needed. */
+    uint32_t bits(uint8_t nbrBits) {
+      if (_poolBits < nbrBits) {
+        _pool = next32();
+        _poolBits = 32;
+      }
+      uint32_t value = nbrBits < 32 ? _pool & ((1UL << nbrBits) - 1) : _pool;
+      _pool = nbrBits < 32 ? _pool >> nbrBits : 0;
+      _poolBits -= nbrBits;
+      return value;
+    }
+
+    /** true or false with equal odds. */
+    bool coin() { return bits(1); }
+
+    /** A number in [0, limit), from 8 bits of the pool. */
+    uint8_t below8(uint8_t limit) { return (bits(8) * limit) >> 8; }
+
+    /** A number in [0, limit), from 16 bits of the pool. */
+    uint16_t below16(uint16_t limit) { return (bits(16) * limit) >> 16; }
+
+  private:
+    uint32_t _state;
+    uint32_t _pool;
+    uint8_t _poolBits;
+};
+
+extern FastRandom fastRandom;
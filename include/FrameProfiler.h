@@ -0,0 +1,91 @@
+/**
+ * @file FrameProfiler.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Time spent in each stage of the frame loop.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * loop() calls lap() as it finishes each piece of work, which charges the
+ * time since the previous lap to that stage.  Stages that run more than once
+ * a frame (the network polls) add up, and at endFrame() each stage's total
+ * for the frame goes into min/average/max statistics over a window of frames,
+ * as PowerTelemetry does for power.  The busy part of every frame, everything
+ * but the idle wait, is also counted in a histogram for the effect showing,
+ * with buckets doubling in width.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define PROFILE_WINDOW_FRAMES 256       // frames per statistics window
+#define PROFILE_MAX_EFFECTS 16          // effects beyond this aren't given a histogram
+#define PROFILE_HISTOGRAM_BUCKETS 8     // 256 us to a 60 FPS frame, the last has no upper bound
+#define PROFILE_FIRST_BUCKET_us 256     // upper bound of the first bucket, each after is double
+
+enum ProfileStage : uint8_t {
+  PROFILE_RENDER,           // drawing the effect
+  PROFILE_SHOW,             // publishing the frame and starting the output
+  PROFILE_STREAM,           // reading E1.31 packets
+  PROFILE_SYNC,             // show clock sync with the other controllers
+  PROFILE_MDNS,             // mdns.run()
+  PROFILE_WEB,              // processAnyWebRequests()
+  PROFILE_WIFI,             // checking on the Wi-Fi connection
+  PROFILE_LOG,              // writing out the event log
+  PROFILE_IDLE,             // waiting out the rest of the frame
+  NBR_OF_PROFILE_STAGES
+};
+
+struct ProfileStats {
+  uint32_t min_us;
+  uint32_t average_us;
+  uint32_t max_us;
+};
+
+class FrameProfiler {
+
+  public:
+    /** Start timing a frame.  Call at the top of loop(). */
+    void startFrame();
+
+    /** Charge the time since the last lap, or the start of the frame, to stage. */
+    void lap(ProfileStage stage);
+
+    /** Close the frame's statistics, histogramming it against the effect that was showing. */
+    void endFrame(uint8_t effectNbr);
+
+    /** A stage's per frame time over the last complete window. */
+    const ProfileStats &stats(ProfileStage stage) const { return _stats[stage]; }
+
+    static const char *stageName(ProfileStage stage);
+
+    /** Upper bound in microseconds of a histogram bucket, UINT32_MAX for the last. */
+    static uint32_t bucketLimit_us(uint8_t bucket);
+
+    /** Frames counted in one bucket of an effect's histogram. */
+    uint32_t histogram(uint8_t effectNbr, uint8_t bucket) const { return _histogram[effectNbr][bucket]; }
+
+    /** Total busy time counted in an effect's histogram, for averages. */
+    uint64_t histogramSum_us(uint8_t effectNbr) const { return _histogramSum_us[effectNbr]; }
+
+  private:
+    uint32_t _lap_us = 0;
+    uint32_t _frame_us[NBR_OF_PROFILE_STAGES] = {};
+
+    // statistics being gathered for the current window
+    uint16_t _windowFrames = 0;
+    uint32_t _windowMin_us[NBR_OF_PROFILE_STAGES];
+    uint32_t _windowMax_us[NBR_OF_PROFILE_STAGES] = {};
+    uint32_t _windowSum_us[NBR_OF_PROFILE_STAGES] = {};
+
+    // statistics of the last complete window
+    ProfileStats _stats[NBR_OF_PROFILE_STAGES] = {};
+
+    // since start up
+    uint32_t _histogram[PROFILE_MAX_EFFECTS][PROFILE_HISTOGRAM_BUCKETS] = {};
+    uint64_t _histogramSum_us[PROFILE_MAX_EFFECTS] = {};
+};
+
+extern FrameProfiler frameProfiler;
@@ -0,0 +1,59 @@
+/**
+ * @file FrameScheduler.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Deadline based frame pacing for the LED loop.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each frame is given a fixed budget measured with micros().  Rather than
+ * sleeping a fixed amount after the work is done the loop asks how much of
+ * the frame is left, spends it on other work (the network), and then waits
+ * only for whatever remains before the next deadline.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class FrameScheduler {
+
+  public:
+    FrameScheduler(uint32_t framePeriod_us);
+
+    /** Mark the start of a frame.  Call once at the top of loop(). */
+    void beginFrame();
+
+    /** Microseconds left before the current frame's deadline, 0 if it has passed. */
+    uint32_t timeRemaining_us() const;
+
+    /** Finish the frame, waiting out any time left until the deadline.
+     * @returns true if the frame overran its deadline.
+     */
+    bool endFrame();
+
+    void setFramePeriod(uint32_t framePeriod_us);
+    uint32_t framePeriod_us() const { return _framePeriod_us; }
+
+    /** Number of frames whose work ran past their deadline. */
+    uint32_t overruns() const { return _overruns; }
+
+    /** Longest frame seen (start of frame until endFrame()) in microseconds. */
+    uint32_t worstFrame_us() const { return _worstFrame_us; }
+
+    /** Duration of the most recently completed frame in microseconds. */
+    uint32_t lastFrame_us() const { return _lastFrame_us; }
+
+    void resetStats();
+
+  private:
+    uint32_t _framePeriod_us;
+    uint32_t _frameStart_us = 0;
+    uint32_t _deadline_us = 0;
+    bool _started = false;
+
+    uint32_t _overruns = 0;
+    uint32_t _worstFrame_us = 0;
+    uint32_t _lastFrame_us = 0;
+};
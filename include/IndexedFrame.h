@@ -0,0 +1,71 @@
+/**
+ * @file IndexedFrame.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief A frame of 4 bit palette indices, for strings too long for 3 bytes a pixel.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * None of the effects use more than a handful of colours at once, so with
+ * LED_INDEXED_FRAME the back and front buffers hold half a byte per pixel and
+ * a 16 colour palette each, and pixels only become GRB in the output driver.
+ * Entry 0 of the palette is the background clearFrame() leaves behind.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#define INDEXED_PALETTE_SIZE 16
+#define INDEXED_FRAME_BYTES(n) (((n) + 1) / 2)
+
+class IndexedFrame {
+
+  public:
+    IndexedFrame(uint8_t *indices, uint16_t nbrLEDS) : _indices(indices), _nbrLEDS(nbrLEDS) {}
+
+    CRGB palette[INDEXED_PALETTE_SIZE];
+
+    uint16_t size() const { return _nbrLEDS; }
+
+    /** Palette index of pixel i, even pixels in the low nibble. */
+    uint8_t get(uint16_t i) const { return (_indices[i >> 1] >> ((i & 1) << 2)) & 0x0F; }
+
+    void set(uint16_t i, uint8_t index) {
+      uint8_t shift = (i & 1) << 2;
+      _indices[i >> 1] = (_indices[i >> 1] & ~(0x0F << shift)) | ((index & 0x0F) << shift);
+    }
+
+    /** Set every pixel to the same index. */
+    void fill(uint8_t index) { memset(_indices, (index & 0x0F) * 0x11, INDEXED_FRAME_BYTES(_nbrLEDS)); }
+
+    /** Copy count colours into the palette from entry first on. */
+    void setPalette(const CRGB *colors, uint8_t count, uint8_t first = 0) {
+      memcpy(palette + first, colors, count * sizeof(CRGB));
+    }
+
+    /** Take the pixels and palette of another frame of the same size. */
+    void copyFrom(const IndexedFrame &frame);
+
+    /** Write count pixels from first on as full colour. */
+    void expand(CRGB *leds, uint16_t first, uint16_t count) const;
+
+    /** Number of pixels using each palette entry. */
+    void histogram(uint16_t counts[INDEXED_PALETTE_SIZE]) const;
+
+  private:
+    uint8_t *_indices;
+    uint16_t _nbrLEDS;
+};
+
+/** An IndexedFrame with its own storage for nbrLEDS pixels. */
+template <uint16_t NBR_LEDS> class IndexedFrameBuffer : public IndexedFrame {
+
+  public:
+    IndexedFrameBuffer() : IndexedFrame(_storage, NBR_LEDS) {}
+
+  private:
+    uint8_t _storage[INDEXED_FRAME_BYTES(NBR_LEDS)];
+};
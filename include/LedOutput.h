@@ -0,0 +1,94 @@
+/**
+ * @file LedOutput.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Owns the LED frame buffer and decides when it is sent to the string.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Sending a frame bit-bangs every pixel with interrupts off, so it is only done
+ * when an effect has actually changed the frame.  Effects call markFrameDirty()
+ * whenever they write to leds.
+ *
+ * Effects render into leds, the back buffer.  At the frame boundary the
+ * finished frame is published to a front buffer which is the only thing the
+ * backend reads, so the next frame can be drawn while the last one is still
+ * going out.  With LED_OUTPUT_SPI_DMA the front buffer is encoded and handed to
+ * the DMA controller once the previous transfer is done.  During a transition
+ * between effects the outgoing effect's frame is blended in as the frame is
+ * published, so the crossfade needs no buffer of its own.
+ *
+ * Every frame sent goes through the colour stage (ColorStage.h), gamma and
+ * the power limited brightness with optional dithering.  The DMA backend does
+ * that as it encodes; the bit-bang backend corrects the front buffer into a
+ * buffer of its own for FastLED to send at full brightness.  When dithering, an
+ * unchanged frame is sent again to move the dither on, as long as the frame
+ * has room for another transmit.
+ *
+ * With LED_INDEXED_FRAME both buffers are IndexedFrames, half a byte a pixel.
+ * The DMA backend encodes straight from the indices; the bit-bang backend
+ * expands the front buffer into its full colour buffer as it sends.
+ *
+ * With more than one string (LED_STRING_COUNT) the front buffer is split
+ * between them, LEDS_PER_STRING pixels each.  The DMA backend sends all strings
+ * at the same time, the bit-bang backend one after the other.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define LED_REFRESH_INTERVAL_ms 1000    // re-send an unchanged frame this often, 0 to never
+
+/** Attach the frame buffer to the LED strings. */
+void beginLedOutput();
+
+/** Note that leds has changed and needs to be shown.
+ *
+ * @param modelledPower_mW the frame's unscaled power by its effect's power
+ * model (see Effects.h), or 0 to cost it from its pixels as it's published.
+ */
+void markFrameDirty(uint32_t modelledPower_mW = 0);
+
+/** Clear the back buffer to black and mark it changed.
+ *
+ * Use this rather than FastLED.clear(), which clears the front buffer that is
+ * being sent (or nothing at all with the DMA backend).  An indexed frame is
+ * set to palette entry 0.
+ */
+void clearFrame();
+
+/** Publish the frame if it has changed, or the refresh interval has passed,
+ * and send it if the backend is free.
+ *
+ * If the DMA backend is still busy with the previous frame the frame stays
+ * pending and goes out from serviceLedOutput().
+ *
+ * @returns true if a frame was sent to the string.
+ */
+bool showFrame();
+
+/** Send a pending frame once the backend is free.  Cheap to call often.
+ *
+ * @returns true if a frame was sent to the string.
+ */
+bool serviceLedOutput();
+
+/** Wait until any pending frame has been sent and the backend is idle.
+ * Only for benchmarks, the frame loop must never block on the output.
+ */
+void waitForLedOutput();
+
+/** Number of times the frame was sent, and how often sending was skipped. */
+uint32_t framesShown();
+uint32_t framesSkipped();
+
+/** Milliseconds from power up until the first frame went out, 0 until it has. */
+uint32_t firstFrame_ms();
+
+/** Frames replaced by a newer one before the backend was free to send them. */
+uint32_t framesDropped();
+
+/** Frames sent to the string over the last second. */
+uint16_t outputFPS();
@@ -0,0 +1,88 @@
+/**
+ * @file PixelOps.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Frame buffer primitives shared by the effects.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The Cortex-M0+ has no divide instruction, so these avoid per pixel % and /
+ * and work in runs of memory copies wherever they can.
+ *
+ * The fill, scale and fade functions work on the buffer a 32 bit word at a
+ * time, four pixels being exactly three words.  Two colour channels are
+ * scaled with each multiply by keeping them in alternate byte lanes
+ * (0x00FF00FF), and the results are bit for bit those of FastLED's scale8()
+ * and fadeToBlackBy().  The M0+ faults on unaligned word access, so a buffer
+ * that isn't 4 byte aligned falls back to a pixel at a time; declare frame
+ * buffers alignas(4).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+/** Build in benchmarkPixelOps(), timing these against FastLED's per pixel calls. */
+#ifndef PIXELOPS_BENCHMARK
+#define PIXELOPS_BENCHMARK 0
+#endif
+
+/** Build one period of a striped pattern, stripeWidth pixels of each colour in turn.
+ *
+ * @param pattern receives nbrOfColors * stripeWidth pixels
+ */
+void fillStripes(CRGB *pattern, const CRGB *colors, uint8_t nbrOfColors, uint8_t stripeWidth);
+
+/** Fill the frame with a periodic pattern, rotated by phase.
+ *
+ * leds[i] becomes pattern[(i + phase) % period].  Only one period is ever
+ * read from pattern, the rest of the frame is copied from what has already
+ * been written.
+ *
+ * @param phase must be less than period
+ */
+void fillRotatingPattern(CRGB *leds, uint16_t nbrLEDS, const CRGB *pattern, uint16_t period, uint16_t phase);
+
+/** Repeat the first written pixels of the frame until it is full.
+ *
+ * @param written pixels already in leds, a whole number of periods
+ */
+void extendPeriodic(CRGB *leds, uint16_t nbrLEDS, uint16_t written);
+
+/** Phase for the next step of a pattern moving one pixel up the string. */
+inline uint16_t rotatePhase(uint16_t phase, uint16_t period) {
+  return phase == 0 ? period - 1 : phase - 1;
+}
+
+/** Set every pixel to color, the same as fill_solid(). */
+void fillPixels(CRGB *leds, uint16_t nbrLEDS, const CRGB &color);
+
+/** Scale every channel by scale/256, the same as nscale8(). */
+void scalePixels(CRGB *leds, uint16_t nbrLEDS, uint8_t scale);
+
+/** Blend two frames into out, weight/256 of to and the rest of from.
+ *
+ * Like nblend(), but with weight running 0-256 so both ends are exact and the
+ * lanes never need more than 16 bits.  out may be either input.
+ */
+void blendPixels(CRGB *out, const CRGB *from, const CRGB *to, uint16_t nbrLEDS, uint16_t weight);
+
+/** Fade every pixel towards black, the same as fadeToBlackBy(). */
+inline void fadePixels(CRGB *leds, uint16_t nbrLEDS, uint8_t fadeAmt) {
+  scalePixels(leds, nbrLEDS, 255 - fadeAmt);
+}
+
+/** Fade only the pixels whose bit is set in mask, bit 0 being leds[0].
+ *
+ * Made for masks drawn from FastRandom::next32(), so at most 32 pixels at a
+ * time.  leds should be 4 byte aligned, as it stays when stepping through a
+ * frame 32 pixels at a time.
+ */
+void fadePixelsMasked(CRGB *leds, uint8_t nbrLEDS, uint8_t fadeAmt, uint32_t mask);
+
+#if PIXELOPS_BENCHMARK
+/** Time the word wide functions against FastLED at a few string lengths and print the results. */
+void benchmarkPixelOps();
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file PowerTelemetry.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Per frame power estimate, power limiting and windowed power statistics.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * This takes over from FastLED.setMaxPowerInMilliWatts().  The LED power is
+ * estimated once per frame with FastLED's integer power model, the same number
+ * is used to pick the brightness that keeps us inside the budget, and it is
+ * kept as statistics for the web pages so they never need to compute it.
+ *
+ * Effects draw in perceptual colour and the LEDs are sent it through the
+ * gamma curve (see ColorStage.h), so each channel is costed at its level on
+ * that curve - what the LEDs actually draw - rather than as drawn.  The
+ * brightness scales the corrected levels linearly, so the limiter can still
+ * work it out with a single division.
+ *
+ * A frame drawn by an effect with a power model (see Effects.h) isn't costed
+ * at all.  The model's power is the most any step of the effect draws, so the
+ * brightness worked out from it holds for the whole effect - steady, where
+ * limiting each frame on its own would have the brightness pump as a pattern
+ * moves - and is kept until the model, the target brightness or the budget
+ * changes.  The statistics then record the modelled power for those frames.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "IndexedFrame.h"
+#include "ColorStage.h"
+
+#define POWER_WINDOW_FRAMES 128         // frames per statistics window
+#define POWER_MCU_mW 25                 // allowance for the controller itself, as FastLED does
+
+/** Per channel power at full brightness, FastLED's defaults for WS2812B at 5 V. */
+#define POWER_RED_mW (16 * 5)
+#define POWER_GREEN_mW (11 * 5)
+#define POWER_BLUE_mW (15 * 5)
+#define POWER_DARK_mW (1 * 5)
+
+/** Channel totals of some pixels on the gamma curve, costed the way
+ * calculate_unscaled_power_mW() costs its raw channels.
+ */
+struct PixelPower {
+  uint32_t red = 0;               // sums of gammaCurve levels, 65535 a channel fully on
+  uint32_t green = 0;
+  uint32_t blue = 0;
+  uint32_t pixels = 0;
+
+  void add(const CRGB &pixel, uint32_t count = 1) {
+    red += gammaCurve[pixel.r] * count;
+    green += gammaCurve[pixel.g] * count;
+    blue += gammaCurve[pixel.b] * count;
+    pixels += count;
+  }
+
+  void add(const PixelPower &other, uint32_t times = 1) {
+    red += other.red * times;
+    green += other.green * times;
+    blue += other.blue * times;
+    pixels += other.pixels * times;
+  }
+
+  void remove(const CRGB &pixel) {
+    red -= gammaCurve[pixel.r];
+    green -= gammaCurve[pixel.g];
+    blue -= gammaCurve[pixel.b];
+    pixels--;
+  }
+
+  /** Power at full brightness, without the controller's.  The sums are cut
+   * to 8 bit levels first, so 2400 pixels fully on don't overflow.
+   */
+  uint32_t unscaled_mW() const {
+    return ((red >> 8) * POWER_RED_mW >> 8) + ((green >> 8) * POWER_GREEN_mW >> 8)
+           + ((blue >> 8) * POWER_BLUE_mW >> 8) + POWER_DARK_mW * pixels;
+  }
+};
+
+class PowerTelemetry {
+
+  public:
+    PowerTelemetry(uint8_t targetBrightness, uint32_t maxPower_mW);
+
+    /** Light the indicator LED on this pin whenever the budget forces the brightness down. */
+    void setIndicatorPin(int pin);
+
+    void setTargetBrightness(uint8_t brightness) { _targetBrightness = brightness; _modelledValid = false; }
+    uint8_t targetBrightness() const { return _targetBrightness; }
+
+    void setMaxPower_mW(uint32_t maxPower_mW) { _maxPower_mW = maxPower_mW; _modelledValid = false; }
+    uint32_t maxPower_mW() const { return _maxPower_mW; }
+
+    /** Estimate the power of a frame and record it.
+     *
+     * @returns the brightness to show this frame at to stay within the budget.
+     */
+    uint8_t update(const CRGB *leds, uint16_t nbrLEDS);
+
+    /** The same for an indexed frame, costed from the palette and a count of
+     * each entry rather than from every pixel.
+     */
+    uint8_t update(const IndexedFrame &frame);
+
+    /** The same for a frame whose unscaled power is given by its effect's
+     * power model, without looking at its pixels.
+     */
+    uint8_t updateModelled(uint32_t unscaled_mW);
+
+    /** Brightness chosen for the last frame. */
+    uint8_t brightness() const { return _brightness; }
+
+    /** Power of the last frame as shown, after limiting. */
+    uint32_t frame_mW() const { return _frame_mW; }
+
+    /** Statistics over the last complete window of POWER_WINDOW_FRAMES frames. */
+    uint32_t min_mW() const { return _min_mW; }
+    uint32_t max_mW() const { return _max_mW; }
+    uint32_t average_mW() const { return _average_mW; }
+
+    /** Percentage of frames in the window that had to be dimmed to fit the budget. */
+    uint8_t limitedPercent() const { return _limitedPercent; }
+
+    /** Highest power asked for in the window, before limiting, as a percentage of the budget.
+     * Anything over 100 is the supply size needed to run the effects at full brightness.
+     */
+    uint16_t peakDemandPercent() const { return _peakDemandPercent; }
+
+  private:
+    /** What a frame of some unscaled power comes to at the current target brightness and budget. */
+    struct PowerScale {
+      uint32_t unscaled_mW;
+      uint32_t requested_mW;          // at the target brightness
+      uint32_t shown_mW;              // at the brightness chosen
+      uint8_t brightness;
+      bool limited;
+    };
+
+    PowerScale scaleFor(uint32_t unscaled_mW) const;
+    uint8_t apply(const PowerScale &scale);
+    uint8_t limit(uint32_t unscaled_mW) { return apply(scaleFor(unscaled_mW)); }
+    void record(uint32_t requested_mW, uint32_t shown_mW, bool limited);
+
+    uint8_t _targetBrightness;
+    uint32_t _maxPower_mW;
+    int _indicatorPin = -1;
+    bool _indicatorOn = false;
+
+    uint8_t _brightness;
+    uint32_t _frame_mW = 0;
+
+    PowerScale _modelled;             // the last modelled power's, while _modelledValid
+    bool _modelledValid = false;
+
+    // statistics being gathered for the current window
+    uint16_t _windowFrames = 0;
+    uint16_t _windowLimited = 0;
+    uint32_t _windowSum_mW = 0;
+    uint32_t _windowMin_mW = UINT32_MAX;
+    uint32_t _windowMax_mW = 0;
+    uint32_t _windowPeakRequested_mW = 0;
+
+    // statistics of the last complete window
+    uint32_t _min_mW = 0;
+    uint32_t _max_mW = 0;
+    uint32_t _average_mW = 0;
+    uint8_t _limitedPercent = 0;
+    uint16_t _peakDemandPercent = 0;
+};
+
+extern PowerTelemetry powerTelemetry;
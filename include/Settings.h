@@ -0,0 +1,86 @@
+/**
+ * @file Settings.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Settings kept in the SAMD21's own flash, changed without a rebuild.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The settings live in RAM and are read from there; flash is only read once
+ * at start up and written when a change is saved.  The NINA module's file
+ * system is no use here, opening it stops BLE.
+ *
+ * SETTINGS_ROWS rows of the sketch's flash are given over to the settings.
+ * Each save goes into the next slot along, the oldest row being erased as the
+ * slots come round to it, and carries a sequence number and a CRC - at start
+ * up the valid slot with the highest sequence wins.  So the rows wear evenly,
+ * a save cut short by a power failure leaves the one before it in place, and
+ * a block written by an older build (a lower SETTINGS_VERSION, a shorter
+ * block) is read with the new fields at their defaults.  Uploading a new
+ * sketch erases the flash and with it the settings.
+ *
+ * Writing flash stalls the CPU for the erase and the page writes, about 10 ms
+ * for a save, so saves are only made when a setting actually changes.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define SETTINGS_VERSION 1
+#define SETTINGS_ROWS 8                 // flash rows written in turn, 2 saves each
+#define SETTINGS_HOSTNAME_SIZE 32
+#define SETTINGS_MAX_EFFECTS 16
+
+/** Everything that can be changed without a rebuild.  New fields only ever
+ * go on the end, so blocks saved by older builds still line up.
+ */
+struct SettingsBlock {
+  char hostname[SETTINGS_HOSTNAME_SIZE];
+  uint32_t maxPower_mW;
+  uint8_t brightness;
+  uint8_t effectCount;                          // entries of effectOrder in use, 0 for the table order
+  uint8_t effectOrder[SETTINGS_MAX_EFFECTS];    // effect numbers in the order they're shown
+  uint8_t reserved[2];
+};
+
+class Settings {
+
+  public:
+    /** Start from the build's defaults, HOSTNAME, LED_BRIGHTNESS and MAX_POWER_mW. */
+    Settings();
+
+    /** Pick up the most recently saved settings, if there are any. */
+    void begin();
+
+    const SettingsBlock &current() const { return _current; }
+
+    /** Make block the current settings and save it, if it differs from them.
+     *
+     * @returns false if the block isn't valid or didn't read back from flash
+     * as written, the current settings are left as they were.
+     */
+    bool save(const SettingsBlock &block);
+
+    /** The build's defaults. */
+    static SettingsBlock defaults();
+
+    /** A block is valid with a host name and an effect order the build can use. */
+    static bool isValid(const SettingsBlock &block);
+
+    /** Saves made since the flash was last erased, 0 while running on the defaults. */
+    uint32_t sequence() const { return _sequence; }
+
+  private:
+    SettingsBlock _current;
+    uint32_t _sequence;
+    int _slot;                  // slot holding the current settings, -1 if none
+};
+
+extern Settings settings;
+
+/** Hand the current settings to the modules using them.  The brightness and
+ * power budget change straight away, a new host name at the next connection.
+ */
+void applySettings();
@@ -0,0 +1,30 @@
+/**
+ * @file SettingsForm.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Settings changes sent as a urlencoded form.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * A form is name=value pairs joined with '&', e.g.
+ * brightness=96&max_power_mW=4000&hostname=Porch&effect_order=0,2,4, as sent
+ * by curl -d, an HTML form or URLSearchParams.  Values are decoded - %XX
+ * escapes and '+' for a space - before they're looked at, so the commas of
+ * effect_order may come either way.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "Settings.h"
+
+#define SETTINGS_FORM_VALUE_SIZE 80     // longest decoded value, an effect_order of every effect
+
+/** Apply the name=value pairs of a form to block.
+ *
+ * @returns false for a name we don't know or a value that isn't one.  Whether
+ * the settings make sense together is left to Settings::isValid().
+ */
+bool parseSettingsForm(const char *form, SettingsBlock &block);
@@ -0,0 +1,42 @@
+/**
+ * @file ShowClock.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The show's time in milliseconds, shared by all the controllers.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Effect steps and effect changes are timed from the show clock rather than
+ * millis(), so controllers whose show clocks agree run the same show in step.
+ * The clock is millis() plus an offset that ShowSync steers toward the
+ * reference controller's clock.  Small errors are halved with each
+ * correction, which also smooths out the noise in the measurements, so the
+ * effects never see time jump; only a large error moves the clock in one go.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define SHOW_CLOCK_STEP_ms 250          // errors beyond this are corrected in one jump
+
+class ShowClock {
+
+  public:
+    uint32_t now_ms() const { return millis() + _offset_ms; }
+
+    /** Correct the clock by error_ms, the reference's time less ours. */
+    void steer(int32_t error_ms);
+
+    int32_t offset_ms() const { return _offset_ms; }
+
+    /** Number of times the clock was moved in one jump. */
+    uint32_t jumps() const { return _jumps; }
+
+  private:
+    int32_t _offset_ms = 0;
+    uint32_t _jumps = 0;
+};
+
+extern ShowClock showClock;
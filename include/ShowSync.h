@@ -0,0 +1,78 @@
+/**
+ * @file ShowSync.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Keeps the show clock in step with the other controllers over UDP.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Peers are the other controllers answering for XmasLights_controller in
+ * mDNS, plus any that send us a request.  The one with the lowest IP address,
+ * counting ourselves, is the reference every other controller follows.  Once
+ * a second a follower asks the reference for its show time, noting when the
+ * request left; the reply is taken to be half the round trip old when it
+ * arrives.  Of every SYNC_SAMPLES replies the one with the shortest round
+ * trip, the least upset by Wi-Fi, is used to steer the show clock.  Every
+ * controller answers requests, so whichever becomes the reference is ready.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiNINA.h>
+
+#define SYNC_PORT 5569
+#define SYNC_MAX_PEERS 16
+#define SYNC_INTERVAL_ms 1000           // between requests to the reference
+#define SYNC_SAMPLES 4                  // replies per correction, the quickest round trip is used
+#define SYNC_MAX_RTT_ms 100             // replies slower than this are ignored
+#define SYNC_PEER_TIMEOUT_ms 300000     // forget peers not heard of for this long
+#define SYNC_DISCOVERY_INTERVAL_ms 60000
+#define SYNC_DISCOVERY_TIMEOUT_ms 5000
+#define SYNC_SERVICE_NAME "XmasLights_controller"
+
+class ShowSync {
+
+  public:
+    /** Listen for requests and replies, each time the network comes up. */
+    void begin(IPAddress localIP);
+
+    /** Add or refresh a peer, from mDNS or from a request. */
+    void addPeer(IPAddress ip);
+
+    /** Answer requests, use replies and send a request when one is due. */
+    void poll();
+
+    bool isReference() const { return _reference == _localIP; }
+    uint8_t peerCount() const { return _peerCount; }
+    uint32_t lastRtt_ms() const { return _lastRtt_ms; }
+    int32_t lastError_ms() const { return _lastError_ms; }
+
+  private:
+    void expirePeers();
+    void chooseReference();
+    void handlePacket();
+    void sendRequest();
+
+    struct Peer {
+      IPAddress ip;
+      uint32_t seen_ms;
+    };
+
+    bool _listening = false;
+    IPAddress _localIP;
+    IPAddress _reference;
+    Peer _peers[SYNC_MAX_PEERS];
+    uint8_t _peerCount = 0;
+
+    uint32_t _lastRequest_ms = 0;
+    uint8_t _samples = 0;
+    uint32_t _bestRtt_ms = UINT32_MAX;
+    int32_t _bestError_ms = 0;
+
+    uint32_t _lastRtt_ms = 0;
+    int32_t _lastError_ms = 0;
+};
+
+extern ShowSync showSync;
@@ -0,0 +1,91 @@
+/**
+ * @file StreamInput.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Frames streamed from a sequencer over E1.31 (sACN).
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Packets arrive unicast on the E1.31 port, one universe of up to 170 RGB
+ * pixels each, universe E131_FIRST_UNIVERSE holding the first pixels of the
+ * string.  Only the header is read into a buffer of our own; once it checks
+ * out the pixel data is read from the socket straight into leds, which is
+ * already the back buffer.  A poll reads at most STREAM_MAX_PACKETS_PER_POLL
+ * packets, which keeps it inside the stream task's slice; the rest stay queued
+ * on the NINA for the next poll, one idle pass later, so a burst of universes
+ * can take a few passes to land.  Each packet overwrites its universe's pixels,
+ * so the newest data read by the time a frame is shown is what it shows.  Each
+ * universe's sequence number is tracked so packets that arrive out of order
+ * are dropped as late and gaps are counted as lost.  While packets keep coming the effects are paused; after
+ * STREAM_TIMEOUT_ms without any, or when the source says it has stopped, the
+ * effects carry on.
+ *
+ * Streaming needs the full colour frame, with LED_INDEXED_FRAME it is left
+ * out.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "XmasLights.h"
+
+#define STREAM_INPUT (!LED_INDEXED_FRAME)
+
+#define E131_PORT 5568
+#define E131_HEADER_SIZE 126            // root, framing and DMP layers up to the start code
+#define E131_PIXELS_PER_UNIVERSE 170
+#define E131_UNIVERSES ((NUMBER_OF_LIGHTS + E131_PIXELS_PER_UNIVERSE - 1) / E131_PIXELS_PER_UNIVERSE)
+#define E131_LATE_WINDOW 20             // sequence numbers this far behind are late, further is a restart
+#define STREAM_TIMEOUT_ms 2500          // E1.31's network data loss time
+#define STREAM_MAX_PACKETS_PER_POLL 2   // the rest are picked up on the next pass
+
+class StreamInput {
+
+  public:
+    /** Listen for E1.31, each time the network comes up. */
+    void begin();
+
+    /** Read the packets that are waiting, call regularly. */
+    void poll();
+
+    /** True while a sequencer is sending, the effects should leave leds alone. */
+    bool active() const { return _active; }
+
+    /** Mark the frame dirty if packets have changed leds since the last call.
+     * @returns true if they had.
+     */
+    bool takeFrame();
+
+    uint32_t packets() const { return _packets; }
+    uint32_t latePackets() const { return _late; }
+    uint32_t lostPackets() const { return _lost; }
+    uint32_t invalidPackets() const { return _invalid; }
+
+    /** Packets accepted over the last second. */
+    uint16_t packetsPerSecond() const { return _packetsPerSecond; }
+
+  private:
+    void readPacket(int size);
+    bool acceptSequence(uint8_t universeIndex, uint8_t sequence);
+
+    bool _listening = false;
+    bool _active = false;
+    bool _frameChanged = false;
+    uint32_t _lastPacket_ms = 0;
+
+    uint8_t _lastSequence[E131_UNIVERSES];
+    bool _sequenceValid[E131_UNIVERSES] = {};
+
+    uint32_t _packets = 0;
+    uint32_t _late = 0;
+    uint32_t _lost = 0;
+    uint32_t _invalid = 0;
+
+    uint32_t _windowStart_ms = 0;
+    uint16_t _windowPackets = 0;
+    uint16_t _packetsPerSecond = 0;
+};
+
+extern StreamInput streamInput;
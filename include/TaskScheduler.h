@@ -0,0 +1,74 @@
+/**
+ * @file TaskScheduler.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Cooperative background tasks run in the gaps between frames.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The frame is the one high priority task; loop() renders and shows it first
+ * and only then hands the rest of the frame to runIdle().  Background tasks
+ * are plain functions that do a bounded piece of work and return, so no task
+ * needs a stack of its own.  Each declares the longest slice it takes and is
+ * only started when that much of the frame is left, in the order they were
+ * added, pass after pass until the gap is used up.  A task that has been kept
+ * waiting TASK_STARVATION_ms is started anyway, so a frame rate that leaves no
+ * gaps slows the network rather than stopping it.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+
+#define TASK_MAX_TASKS 8
+#define TASK_STARVATION_ms 250          // a due task kept waiting this long runs even in a short gap
+
+typedef void (*TaskFunction)();
+
+struct TaskStats {
+  uint32_t runs = 0;
+  uint32_t deferred = 0;                // frames the task was due but didn't fit in the gap
+  uint32_t worst_us = 0;                // longest single run
+};
+
+class TaskScheduler {
+
+  public:
+    TaskScheduler(const FrameScheduler &frames);
+
+    /** Add a background task, tasks added first run first.
+     * @param slice_us the longest the task takes, it isn't started with less of the frame left.
+     * @param interval_ms least time between runs, 0 runs it on every pass.
+     * @param stage the profiler stage its time is charged to.
+     * @returns false if the task list is full.
+     */
+    bool addTask(const char *name, TaskFunction run, uint16_t slice_us, uint16_t interval_ms, ProfileStage stage);
+
+    /** Run the background tasks until reserve_us before the frame's deadline. */
+    void runIdle(uint32_t reserve_us);
+
+    uint8_t taskCount() const { return _taskCount; }
+    const char *taskName(uint8_t task) const { return _tasks[task].name; }
+    const TaskStats &taskStats(uint8_t task) const { return _tasks[task].stats; }
+
+  private:
+    struct Task {
+      const char *name;
+      TaskFunction run;
+      uint16_t slice_us;
+      uint16_t interval_ms;
+      ProfileStage stage;
+      uint32_t lastRun_ms;
+      TaskStats stats;
+    };
+
+    const FrameScheduler &_frames;
+    Task _tasks[TASK_MAX_TASKS];
+    uint8_t _taskCount = 0;
+};
+
+extern TaskScheduler taskScheduler;
@@ -0,0 +1,48 @@
+/**
+ * @file WebServer.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Non-blocking status web server.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define HTTP_PORT 80
+#define HTTP_CLIENT_TIMEOUT_ms 2000     // drop clients that haven't finished by then
+#define HTTP_POLL_BUDGET_us 2000        // most time a single poll may spend on a client
+#define HTTP_POLL_BYTE_BUDGET 512       // most bytes read from a client in a single poll
+#define HTTP_WRITE_CHUNK 1024           // largest single write to the client
+#define HTTP_STATUS_PAGE_SIZE 1536     // the page shell, built once, and its header
+#define HTTP_STATUS_HEADER_ROOM 192
+#define HTTP_STATUS_MAX_AGE_s 300       // browsers revalidate the shell with If-None-Match after this
+#define HTTP_ERROR_RESPONSE_SIZE 128
+#define HTTP_DATA_SIZE 1536             // largest part of /metrics or /status.json, they go out a part at a time
+#define HTTP_RX_BUFFER_SIZE 256         // longest header line we look at, longer ones are skipped
+#define HTTP_MAX_METHOD 8
+#define HTTP_MAX_PATH 128
+#define HTTP_MAX_HOST 64                // longest Host or Origin compared, longer ones are cut short
+#define HTTP_MAX_BODY 192               // room for a form changing all the settings
+#define HTTP_SETTINGS_SAVE_INTERVAL_ms 5000   // shortest time between settings written to flash
+#define HTTP_EVENT_CLIENTS 3            // open /events streams, each holds one of the NINA's sockets
+#define HTTP_EVENTS_INTERVAL_ms 1000    // how often each stream is sent what's changed
+#define HTTP_EVENTS_KEEPALIVE_ms 15000  // longest a stream goes without a write
+#define HTTP_EVENT_MESSAGE_SIZE 256
+
+/** Start listening for web clients. */
+void beginWebServer();
+
+/** Advance the web connection by at most one poll's worth of work.
+ *
+ * Never waits on the client; whatever isn't available now is picked up on a
+ * later call.
+ */
+void processAnyWebRequests();
+
+/** The /events streams open or being opened. */
+uint8_t eventClientCount();
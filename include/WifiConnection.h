@@ -0,0 +1,83 @@
+/**
+ * @file WifiConnection.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Wi-Fi association and reconnection without blocking the lights.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * WiFiNINA's begin() normally waits for the association to finish.  With its
+ * timeout set to 0 it only starts it, and service(), run as a background
+ * task, polls the status from there.  An attempt that doesn't connect within
+ * WIFI_CONNECT_TIMEOUT_ms is abandoned and retried after a backoff that
+ * doubles up to WIFI_MAX_BACKOFF_ms, and a lost connection goes back through
+ * the same steps.  Every time the connection comes up the onConnected
+ * callback is run, so the servers sitting on it can be started again.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define WIFI_CONNECT_TIMEOUT_ms 15000   // give up on an association attempt after this
+#define WIFI_MIN_BACKOFF_ms 1000        // wait before the first retry, doubled on each failure
+#define WIFI_MAX_BACKOFF_ms 60000
+
+enum WifiState {
+  WIFI_WAITING,             // not connected, waiting out the backoff
+  WIFI_CONNECTING,          // association started, polling for it to finish
+  WIFI_CONNECTED
+};
+
+class WifiConnection {
+
+  public:
+    typedef void (*ConnectedCallback)();
+
+    WifiConnection(ConnectedCallback onConnected);
+
+    /** Start connecting, returns straight away.
+     *
+     * hostname is read again before each attempt, so a name changed in place
+     * is registered from the next connection.
+     */
+    void begin(const char *ssid, const char *password, const char *hostname);
+
+    /** Advance the state machine, call regularly. */
+    void service();
+
+    WifiState state() const { return _state; }
+    static const char *stateName(WifiState state);
+
+    /** Milliseconds from power up until the first connection, 0 until there is one. */
+    uint32_t firstConnected_ms() const { return _firstConnected_ms; }
+
+    /** Times the connection came back after being lost. */
+    uint32_t reconnects() const { return _reconnects; }
+
+    /** Association attempts that timed out or failed. */
+    uint32_t failedAttempts() const { return _failedAttempts; }
+
+  private:
+    void startAttempt();
+    void retryLater(uint32_t wait_ms);
+
+    ConnectedCallback _onConnected;
+    const char *_ssid = nullptr;
+    const char *_password = nullptr;
+    const char *_hostname = nullptr;
+
+    WifiState _state = WIFI_WAITING;
+    uint32_t _stateSince_ms = 0;
+    uint32_t _wait_ms = 0;
+    uint32_t _backoff_ms = WIFI_MIN_BACKOFF_ms;   // wait after the next failed attempt
+    bool _started = false;
+    bool _everConnected = false;
+
+    uint32_t _firstConnected_ms = 0;
+    uint32_t _reconnects = 0;
+    uint32_t _failedAttempts = 0;
+};
+
+extern WifiConnection wifiConnection;
@@ -0,0 +1,84 @@
+/**
+ * @file Ws2812Dma.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief WS2812B output from a SAMD21 SERCOM in SPI mode, fed by DMA.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every WS2812B bit is sent as three SPI bits at 2.4 MHz, 100 for a zero and
+ * 110 for a one, so each pixel becomes 9 bytes of SPI data.  Once a frame is
+ * encoded the DMA controller clocks it out on its own and the CPU is free to
+ * render the next frame and service the network, with interrupts left on.
+ *
+ * Each string needs its own SERCOM and DMA channel.  Strings started together
+ * transmit in parallel.
+ *
+ * @note The SERCOMs used are given by WS2812_DMA_PORTS.  The default is D3 on
+ * the Nano 33 IoT (PB11, SERCOM4 PAD3 on peripheral D).  SERCOM4 is also Wire
+ * on that board, so this backend can't be used with I2C.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "IndexedFrame.h"
+#include "ColorStage.h"
+
+#define WS2812_SPI_BYTES_PER_PIXEL 9
+#define WS2812_LATCH_BYTES 90           // > 280 us of low line to latch the frame
+
+/** Size of the encode buffer needed for a string of n pixels. */
+#define WS2812_DMA_BUFFER_SIZE(n) ((n) * WS2812_SPI_BYTES_PER_PIXEL + WS2812_LATCH_BYTES)
+
+/** Where a string is wired - the SERCOM behind its data pin and how to reach it. */
+struct Ws2812DmaPort {
+  SERCOM *sercom;               // the core's SERCOM object, e.g. &sercom4
+  Sercom *registers;            // the same SERCOM's registers, e.g. SERCOM4
+  uint8_t dmaTrigger;           // the SERCOM's DMAC TX trigger, e.g. SERCOM4_DMAC_ID_TX
+  uint8_t pin;                  // Arduino pin number of the data line
+  EPioType pinMux;              // PIO_SERCOM or PIO_SERCOM_ALT, whichever gives the SERCOM on that pin
+  SercomSpiTXPad txPad;         // pad layout that puts the SPI data out on the pin's pad
+};
+
+class Ws2812Dma {
+
+  public:
+    /**
+     * @param port the SERCOM and pin the string is on
+     * @param dmaChannel DMA channel to use, one per string
+     * @param buffer encode buffer of WS2812_DMA_BUFFER_SIZE(nbrLEDS) bytes
+     * @param nbrLEDS number of pixels on the string
+     */
+    void begin(const Ws2812DmaPort &port, uint8_t dmaChannel, uint8_t *buffer, uint16_t nbrLEDS);
+
+    /** True while the previous frame is still being transmitted. */
+    bool busy() const;
+
+    /** Encode a frame through the colour stage, ready for start().  Must not be called while busy().
+     * @param firstPixel the string's first pixel in the whole frame, for the dither pattern
+     */
+    void encode(const CRGB *leds, uint16_t firstPixel, const ColorStage &stage);
+
+    /** Encode this string's pixels of an indexed frame, starting at pixel first.
+     *
+     * Each palette entry is encoded once and copied to its pixels, which is
+     * cheaper than encoding every pixel.  Being shared, the entries aren't
+     * dithered.
+     */
+    void encode(const IndexedFrame &frame, uint16_t first, const ColorStage &stage);
+
+    /** Start transmitting the encoded frame.  Returns straight away. */
+    void start();
+
+    /** Encode a frame and start transmitting it. */
+    void show(const CRGB *leds, const ColorStage &stage) { encode(leds, 0, stage); start(); }
+
+  private:
+    uint8_t _dmaChannel = 0;
+    uint8_t *_buffer = NULL;
+    uint16_t _nbrLEDS = 0;
+};
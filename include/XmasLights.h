@@ -0,0 +1,80 @@
+/**
+ * @file XmasLights.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Global defaults and the state shared between the controller's modules.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "FrameScheduler.h"
+#include "IndexedFrame.h"
+
+/** The installation being built - its strings, pins, power budget, names and
+ * effect pattern sizes (see include/installations/Library.h for the settings
+ * it must give).  Each installation is an environment in platformio.ini that
+ * points INSTALLATION_CONFIG at its own header.
+ */
+#ifndef INSTALLATION_CONFIG
+#define INSTALLATION_CONFIG "installations/Library.h"
+#endif
+#include INSTALLATION_CONFIG
+
+#define NUMBER_OF_LIGHTS (LED_STRING_COUNT * LEDS_PER_STRING)
+
+/** Global defaults */
+#define BAKED_EFFECTS 1                 // draw the train, candy cane and flag from flash rather than live
+#define SECONDS_BETWEEN_EFFECTS 5
+#define EFFECT_TRANSITION_ms 1000       // crossfade from one effect to the next, 0 cuts straight over
+#define SHOW_SYNC 1                     // share a show clock with the other controllers found by mDNS
+#define FRAMES_PER_SECOND 60
+#define DITHER_FRAMES_PER_SECOND 120    // frame rate while dithering, fast enough not to flicker
+#define LED_GAMMA 2.2                   // effects draw in perceptual colour, see ColorStage.h
+#define NETWORK_POLL_RESERVE_us 1000    // don't start network work with less than this left in a frame
+#define TASK_OUTPUT_SLICE_us 200        // background task time slices, see TaskScheduler.h
+#define TASK_STREAM_SLICE_us 2000       // two E1.31 packets over SPI
+#define TASK_SYNC_SLICE_us 1000
+#define TASK_MDNS_SLICE_us 1000
+#define TASK_WIFI_SLICE_us 2000         // WiFi.begin() itself takes a while over SPI
+#define TASK_LOG_SLICE_us 500           // a Serial line or a log datagram, see EventLog.h
+#define WIFI_CHECK_INTERVAL_ms 250
+#define RANDOM_SEED 0                   // 0 seeds the effects from noise, anything else repeats the same show
+
+/** LED output backend - 0 bit-bangs the strings with FastLED, one after the
+ * other.  1 sends them from SERCOMs with DMA, all strings in parallel and
+ * without holding the CPU (see Ws2812Dma.h).  Usually set from platformio.ini.
+ */
+#ifndef LED_OUTPUT_SPI_DMA
+#define LED_OUTPUT_SPI_DMA 0
+#endif
+
+/** Frame buffer format - 0 is full colour, 3 bytes a pixel.  1 stores 4 bit
+ * palette indices, for strings too long to double buffer in full colour (see
+ * IndexedFrame.h).
+ */
+#ifndef LED_INDEXED_FRAME
+#define LED_INDEXED_FRAME 0
+#endif
+
+/** Temporal dithering of the levels lost to gamma and brightness - 1 re-sends
+ * the frame at DITHER_FRAMES_PER_SECOND with the dither moved on (see
+ * ColorStage.h).  Bit-banging holds the CPU for every frame sent, so it is only
+ * on by default with the DMA backend.
+ */
+#ifndef LED_DITHER
+#define LED_DITHER LED_OUTPUT_SPI_DMA
+#endif
+
+#if LED_INDEXED_FRAME
+extern IndexedFrameBuffer<NUMBER_OF_LIGHTS> leds;
+#else
+extern CRGBArray<NUMBER_OF_LIGHTS> leds;
+#endif
+extern FrameScheduler frameScheduler;
@@ -0,0 +1,33 @@
+/**
+ * @file FrontPorch.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The front porch trees - two strings of 100, on D3 and D4.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Built by the front_porch environment, which also picks the DMA backend so
+ * the two strings go out together.
+ */
+
+#pragma once
+
+#define HOSTNAME "FrontPorch_XmasLights"
+#define DATA_PIN 3
+
+#define LED_STRING_COUNT 2
+#define LEDS_PER_STRING 100
+#define LED_STRING_PINS { DATA_PIN, 4 }
+#define LED_BRIGHTNESS 96
+#define MAX_POWER_mW 8000               // 2A supply
+#define E131_FIRST_UNIVERSE 2           // the library has universe 1
+
+#define CANDY_STRIPE_WIDTH 5
+#define FLAG_STRIPE_WIDTH 5
+#define TRAIN_CAR_LENGTH 8
+
+#define WS2812_DMA_PORTS { \
+  { &sercom4, SERCOM4, SERCOM4_DMAC_ID_TX, DATA_PIN, PIO_SERCOM_ALT, SPI_PAD_3_SCK_1 }, \
+  { &sercom0, SERCOM0, SERCOM0_DMAC_ID_TX, 4, PIO_SERCOM_ALT, SPI_PAD_3_SCK_1 } \
+}
@@ -0,0 +1,42 @@
+/**
+ * @file Library.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The library tree - one string of 150 on D3.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The default installation, built by the nano_33_iot environments.
+ */
+
+#pragma once
+
+#define HOSTNAME "Library_XmasLights"
+#define DATA_PIN 3
+
+/** Strings of lights driven by this controller.  Effects see them as one
+ * run of NUMBER_OF_LIGHTS pixels, string 0 first.
+ */
+#define LED_STRING_COUNT 1
+#define LEDS_PER_STRING 150
+#define LED_STRING_PINS { DATA_PIN }    // one data pin per string
+#define LED_BRIGHTNESS 64
+#define MAX_POWER_mW 5000
+#define E131_FIRST_UNIVERSE 1           // E1.31 universe carrying this controller's first 170 pixels
+
+#define CANDY_STRIPE_WIDTH 5
+#define FLAG_STRIPE_WIDTH 5
+#define TRAIN_CAR_LENGTH 10
+
+/** SERCOM behind each string's data pin for the DMA backend, in string order.
+ *
+ * The default is D3 on the Nano 33 IoT.  Other usable pins on that board, if
+ * the peripheral normally on the SERCOM isn't needed:
+ *   D4  { &sercom0, SERCOM0, SERCOM0_DMAC_ID_TX, 4, PIO_SERCOM_ALT, SPI_PAD_3_SCK_1 }
+ *   D11 { &sercom1, SERCOM1, SERCOM1_DMAC_ID_TX, 11, PIO_SERCOM, SPI_PAD_0_SCK_1 }    (SPI)
+ *   D1  { &sercom5, SERCOM5, SERCOM5_DMAC_ID_TX, 1, PIO_SERCOM_ALT, SPI_PAD_2_SCK_3 }  (Serial1)
+ */
+#define WS2812_DMA_PORTS { \
+  { &sercom4, SERCOM4, SERCOM4_DMAC_ID_TX, DATA_PIN, PIO_SERCOM_ALT, SPI_PAD_3_SCK_1 } \
+}
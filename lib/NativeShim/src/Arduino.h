@@ -0,0 +1,43 @@
+/**
+ * @file Arduino.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Stand in for the Arduino core in the native environment.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Only what the effect kernels use.  Time only moves when the test moves it,
+ * see advanceMillis().
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define A0 14
+#define LOW 0
+#define HIGH 1
+
+uint32_t millis();
+uint32_t micros();
+void yield();
+int analogRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+/** Move the fake clock on, millis() and micros() never advance by themselves. */
+void advanceMillis(uint32_t ms);
+void advanceMicros(uint32_t us);
@@ -0,0 +1,110 @@
+/**
+ * @file FastLED.h
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Stand in for FastLED in the native environment.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The pixel maths (scale8, nscale8, fadeToBlackBy and setHue's rainbow) is the
+ * same as FastLED's so frames match the device, but there is no output.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+enum HSVHue {
+  HUE_RED = 0, HUE_ORANGE = 32, HUE_YELLOW = 64, HUE_GREEN = 96,
+  HUE_AQUA = 128, HUE_BLUE = 160, HUE_PURPLE = 192, HUE_PINK = 224
+};
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+  return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+struct CRGB {
+  union {
+    struct {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    DarkBlue = 0x00008B,
+    DarkGreen = 0x006400,
+    DarkRed = 0x8B0000,
+    Green = 0x008000,
+    Orange = 0xFFA500,
+    Purple = 0x800080,
+    Red = 0xFF0000,
+    White = 0xFFFFFF,
+  };
+
+  CRGB() {}
+  CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+  CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+  bool operator==(const CRGB &rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+  bool operator!=(const CRGB &rhs) const { return !(*this == rhs); }
+
+  CRGB &nscale8(uint8_t scaledown) {
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return *this;
+  }
+
+  CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+
+  /** Full saturation and value on FastLED's rainbow colour wheel. */
+  CRGB &setHue(uint8_t hue);
+};
+
+template <int SIZE> class CRGBArray {
+  public:
+    CRGB &operator[](int x) { return entries[x]; }
+    operator CRGB *() { return entries; }
+    int size() const { return SIZE; }
+
+  private:
+    CRGB entries[SIZE];
+};
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color);
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale);
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy);
+
+/** Runs the following statement at most once every N ms of the fake clock. */
+class CEveryNMillis {
+  public:
+    CEveryNMillis(uint32_t period) : _period(period), _last(millis()) {}
+    bool ready() {
+      uint32_t now = millis();
+      if (now - _last < _period)
+        return false;
+      _last = now;
+      return true;
+    }
+
+  private:
+    uint32_t _period;
+    uint32_t _last;
+};
+
+#define EVERY_N_MILLIS_CAT(a, b) a##b
+#define EVERY_N_MILLIS_NAME(line) EVERY_N_MILLIS_CAT(everyNMillis, line)
+#define EVERY_N_MILLISECONDS(N) static CEveryNMillis EVERY_N_MILLIS_NAME(__LINE__)(N); if (EVERY_N_MILLIS_NAME(__LINE__).ready())
+#define EVERY_N_SECONDS(N) EVERY_N_MILLISECONDS((N) * 1000UL)
@@ -0,0 +1,89 @@
+/**
+ * @file NativeShim.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Arduino and FastLED stand ins for the native environment.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+static uint64_t clock_us = 0;
+
+uint32_t millis() {
+  return clock_us / 1000;
+}
+
+uint32_t micros() {
+  return clock_us;
+}
+
+void advanceMillis(uint32_t ms) {
+  clock_us += (uint64_t)ms * 1000;
+}
+
+void advanceMicros(uint32_t us) {
+  clock_us += us;
+}
+
+void yield() {}
+
+int analogRead(uint8_t pin) {
+  (void)pin;
+  return 0;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  (void)pin;
+  (void)value;
+}
+
+long random(long howBig) {
+  return howBig ? rand() % howBig : 0;
+}
+
+long random(long howSmall, long howBig) {
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+void randomSeed(unsigned long seed) {
+  srand(seed);
+}
+
+CRGB &CRGB::setHue(uint8_t hue) {
+
+  // FastLED's hsv2rgb_rainbow() at full saturation and value.
+  uint8_t offset8 = (hue & 0x1F) << 3;
+  uint8_t third = scale8(offset8, 85);
+  uint8_t twothirds = scale8(offset8, 170);
+
+  switch (hue >> 5) {
+    case 0:  r = 255 - third;     g = third;             b = 0;                 break;
+    case 1:  r = 171;             g = 85 + third;        b = 0;                 break;
+    case 2:  r = 171 - twothirds; g = 170 + third;       b = 0;                 break;
+    case 3:  r = 0;               g = 255 - third;       b = third;             break;
+    case 4:  r = 0;               g = 171 - twothirds;   b = 85 + twothirds;    break;
+    case 5:  r = third;           g = 0;                 b = 255 - third;       break;
+    case 6:  r = 85 + third;      g = 0;                 b = 171 - third;       break;
+    default: r = 170 + third;     g = 0;                 b = 85 - third;        break;
+  }
+  return *this;
+}
+
+void fill_solid(CRGB *leds, int numToFill, const CRGB &color) {
+  for (int i = 0; i < numToFill; i++)
+    leds[i] = color;
+}
+
+void nscale8(CRGB *leds, uint16_t numLeds, uint8_t scale) {
+  for (uint16_t i = 0; i < numLeds; i++)
+    leds[i].nscale8(scale);
+}
+
+void fadeToBlackBy(CRGB *leds, uint16_t numLeds, uint8_t fadeBy) {
+  nscale8(leds, numLeds, 255 - fadeBy);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file BakedPatterns.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Effects stored as one period of palette indexed pixels in flash.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "PixelOps.h"
+#include "PowerTelemetry.h"
+#include "BakedPatterns.h"
+
+/** Palette index of pixel i of the pattern. */
+static inline uint8_t bakedIndex(const BakedPattern &pattern, uint16_t i) {
+  return (pattern.indices[i >> 2] >> ((i & 3) * 2)) & 3;
+}
+
+/** Expand count pixels of the pattern starting at index first, wrapping at its end. */
+static void expand(CRGB *leds, uint16_t count, const BakedPattern &pattern, uint16_t first) {
+
+  uint16_t i = first;
+
+  while (count--) {
+    *leds++ = pattern.palette[bakedIndex(pattern, i)];
+    if (++i == pattern.length)
+      i = 0;
+  }
+}
+
+void renderBakedPattern(CRGB *leds, uint16_t nbrLEDS, const BakedPattern &pattern, uint16_t position) {
+
+  if (pattern.mode == BAKED_ROTATE) {
+    // One period from flash, the rest is copies of it.
+    uint16_t written = min(pattern.length, nbrLEDS);
+    expand(leds, written, pattern, position);
+    extendPeriodic(leds, nbrLEDS, written);
+    return;
+  }
+
+  fillPixels(leds, nbrLEDS, pattern.palette[0]);
+  if (position < nbrLEDS)
+    expand(leds + position, min(pattern.length, (uint16_t)(nbrLEDS - position)), pattern, 0);
+}
+
+void renderBakedPattern(IndexedFrame &frame, uint16_t nbrLEDS, const BakedPattern &pattern, uint16_t position) {
+
+  frame.setPalette(pattern.palette, BAKED_PALETTE_SIZE);
+
+  if (pattern.mode == BAKED_ROTATE) {
+    uint16_t i = position;
+    for (uint16_t j = 0; j < nbrLEDS; j++) {
+      frame.set(j, bakedIndex(pattern, i));
+      if (++i == pattern.length)
+        i = 0;
+    }
+    return;
+  }
+
+  frame.fill(0);
+  for (uint16_t i = 0; i < pattern.length && position + i < nbrLEDS; i++)
+    frame.set(position + i, bakedIndex(pattern, i));
+}
+
+uint32_t bakedPatternPower_mW(const BakedPattern &pattern, uint16_t nbrLEDS) {
+
+  uint32_t most_mW = 0;
+
+  if (pattern.mode == BAKED_ROTATE) {
+    // The whole periods cost the same at any phase, only the part period left over depends on it.
+    PixelPower period;
+    for (uint16_t i = 0; i < pattern.length; i++)
+      period.add(pattern.palette[bakedIndex(pattern, i)]);
+
+    uint16_t part = nbrLEDS % pattern.length;
+    for (uint16_t phase = 0; phase < (part ? pattern.length : 1); phase++) {
+      PixelPower power;
+      power.add(period, nbrLEDS / pattern.length);
+      for (uint16_t i = 0, k = phase; i < part; i++) {
+        power.add(pattern.palette[bakedIndex(pattern, k)]);
+        if (++k == pattern.length)
+          k = 0;
+      }
+      most_mW = max(most_mW, power.unscaled_mW());
+    }
+    return most_mW;
+  }
+
+  // A sliding pattern is all on the string, or the start of it is, over palette[0].
+  PixelPower power;
+  power.add(pattern.palette[0], nbrLEDS);
+  for (uint16_t i = 0; i < pattern.length && i < nbrLEDS; i++) {
+    power.remove(pattern.palette[0]);
+    power.add(pattern.palette[bakedIndex(pattern, i)]);
+    most_mW = max(most_mW, power.unscaled_mW());
+  }
+  return most_mW;
+}
+
+uint16_t nextBakedPosition(const BakedPattern &pattern, uint16_t position, uint16_t nbrLEDS) {
+
+  if (pattern.mode == BAKED_ROTATE)
+    return rotatePhase(position, pattern.length);
+
+  return position + 1 < nbrLEDS ? position + 1 : 0;
+}
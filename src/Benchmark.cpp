@@ -0,0 +1,104 @@
+/**
+ * @file Benchmark.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief On-target cycle counts for the effects and the show path.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "Benchmark.h"
+
+#if BENCHMARK_MODE
+
+#include "XmasLights.h"
+#include "FastRandom.h"
+#include "LedOutput.h"
+#include "Effects.h"
+
+uint32_t cycleCount() {
+
+  // millis() and VAL have to come from the same tick, read again if the
+  // SysTick interrupt got in between.
+  uint32_t ms, val;
+  do {
+    ms = millis();
+    val = SysTick->VAL;
+  } while (ms != millis());
+
+  uint32_t reload = SysTick->LOAD;
+  return ms * (reload + 1) + (reload - val);
+}
+
+/** Cycle counts of one thing, timed over and over. */
+struct CycleStats {
+  uint32_t min = UINT32_MAX;
+  uint32_t max = 0;
+  uint64_t sum = 0;
+  uint16_t count = 0;
+
+  void add(uint32_t cycles) {
+    min = cycles < min ? cycles : min;
+    max = cycles > max ? cycles : max;
+    sum += cycles;
+    count++;
+  }
+
+  uint32_t average() const { return count ? sum / count : 0; }
+};
+
+static uint32_t cyclesTo_us(uint32_t cycles) {
+  return cycles / (F_CPU / 1000000);
+}
+
+static void renderStep(const Effect &effect) {
+#if LED_INDEXED_FRAME
+  effect.renderIndexed(leds, NUMBER_OF_LIGHTS);
+#else
+  effect.render(leds, NUMBER_OF_LIGHTS);
+#endif
+}
+
+static void printRow(const char *name, const CycleStats &render, const CycleStats &show, const CycleStats &sent) {
+  BENCHMARK_PRINTF("%-22s %8lu %8lu %8lu %8lu %8lu %8lu us\n", name,
+      (unsigned long)render.min, (unsigned long)render.average(), (unsigned long)render.max,
+      (unsigned long)show.average(), (unsigned long)sent.average(), (unsigned long)cyclesTo_us(sent.average()));
+}
+
+void runBenchmarks() {
+
+  BENCHMARK_PRINTF("\nBenchmark - %lu MHz, %u flash wait states, %u LEDs, %s output, %s frame\n",
+      (unsigned long)(F_CPU / 1000000), (unsigned int)NVMCTRL->CTRLB.bit.RWS, NUMBER_OF_LIGHTS,
+      LED_OUTPUT_SPI_DMA ? "DMA" : "bit-bang", LED_INDEXED_FRAME ? "indexed" : "full colour");
+  BENCHMARK_PRINTF("Cycles over %u frames: render min/avg/max, show is the CPU time of showFrame(),\n"
+      "sent is from the start of showFrame() until the string has the frame.\n", BENCHMARK_FRAMES);
+  BENCHMARK_PRINTF("%-22s %8s %8s %8s %8s %8s\n", "effect", "min", "avg", "max", "show", "sent");
+
+  for (uint8_t e = 0; e < effectCount(); e++) {
+    const Effect &effect = getEffect(e);
+    CycleStats render, show, sent;
+
+    fastRandom.setSeed(BENCHMARK_SEED);
+    selectEffect(e);
+
+    for (uint16_t f = 0; f < BENCHMARK_FRAMES; f++) {
+      uint32_t started = cycleCount();
+      renderStep(effect);
+      render.add(cycleCount() - started);
+
+      markFrameDirty();
+      waitForLedOutput();
+      started = cycleCount();
+      showFrame();
+      show.add(cycleCount() - started);
+      waitForLedOutput();
+      sent.add(cycleCount() - started);
+    }
+
+    printRow(effect.name, render, show, sent);
+  }
+}
+
+#endif
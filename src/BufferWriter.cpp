@@ -0,0 +1,96 @@
+/**
+ * @file BufferWriter.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Text output into a fixed buffer, without printf or the heap.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "BufferWriter.h"
+
+static const uint32_t powersOf10[] = {
+  1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+};
+
+BufferWriter &BufferWriter::append(const char *text) {
+  return append(text, strlen(text));
+}
+
+BufferWriter &BufferWriter::append(const char *text, uint16_t length) {
+
+  if (length > _size - _length) {
+    length = _size - _length;
+    _overflowed = true;
+  }
+  memcpy(_buffer + _length, text, length);
+  _length += length;
+  return *this;
+}
+
+BufferWriter &BufferWriter::append(char c) {
+  return append(&c, 1);
+}
+
+BufferWriter &BufferWriter::append(uint32_t value) {
+
+  char digits[10];
+  uint8_t n = 0;
+
+  for (uint32_t power : powersOf10) {
+    char digit = '0';
+    while (value >= power) {
+      value -= power;
+      digit++;
+    }
+    if (n > 0 || digit != '0' || power == 1)
+      digits[n++] = digit;
+  }
+
+  return append(digits, n);
+}
+
+BufferWriter &BufferWriter::append(int32_t value) {
+
+  if (value < 0) {
+    append('-');
+    return append((uint32_t)0 - (uint32_t)value);
+  }
+  return append((uint32_t)value);
+}
+
+BufferWriter &BufferWriter::append(uint64_t value) {
+
+  if (value <= UINT32_MAX)
+    return append((uint32_t)value);
+
+  // Split into 9 digit halves, only the low half is zero padded.
+  uint32_t high = value / 1000000000;
+  uint32_t low = value - (uint64_t)high * 1000000000;
+  append(high);
+  for (uint32_t power = 100000000; power > 1 && low < power; power /= 10)
+    append('0');
+  return append(low);
+}
+
+BufferWriter &BufferWriter::appendJsonString(const char *text) {
+
+  static const char hex[] = "0123456789abcdef";
+
+  append('"');
+  for (const char *p = text; *p; p++) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      append('\\');
+      append(c);
+    } else if ((uint8_t)c < 0x20) {
+      char escape[6] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0x0f], hex[c & 0x0f] };
+      append(escape, sizeof(escape));
+    } else {
+      append(c);
+    }
+  }
+  return append('"');
+}
@@ -0,0 +1,104 @@
+/**
+ * @file ColorStage.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Gamma, brightness and temporal dithering on the way out to the string.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ColorStage.h"
+
+ColorStage colorStage;
+
+/** x^LED_GAMMA for x in [0, 1], worked out by the compiler.
+ *
+ * x = m * 2^e with m in [0.5, 1) keeps the log series short, and the exp
+ * series is run on a 32nd of the exponent and squared back up.
+ */
+static constexpr double constexprLog(double x) {
+  double result = 0;
+  while (x < 0.5) {
+    x *= 2;
+    result -= 0.69314718055994531;
+  }
+  double y = (x - 1) / (x + 1);
+  double term = y;
+  for (int k = 1; k < 40; k += 2) {
+    result += 2 * term / k;
+    term *= y * y;
+  }
+  return result;
+}
+
+static constexpr double constexprExp(double z) {
+  z /= 32;
+  double sum = 1, term = 1;
+  for (int k = 1; k < 20; k++) {
+    term *= z / k;
+    sum += term;
+  }
+  for (int i = 0; i < 5; i++)
+    sum *= sum;
+  return sum;
+}
+
+struct GammaTable {
+  uint16_t values[COLOR_STAGE_LEVELS];
+
+  constexpr GammaTable() : values() {
+    for (int i = 1; i < COLOR_STAGE_LEVELS; i++)
+      values[i] = (uint16_t)(65535.0 * constexprExp(LED_GAMMA * constexprLog(i / 255.0)) + 0.5);
+  }
+};
+
+static constexpr GammaTable gammaTable;
+
+static_assert(gammaTable.values[0] == 0 && gammaTable.values[255] == 65535, "gamma curve must span the full range");
+
+const uint16_t *const gammaCurve = gammaTable.values;
+
+void ColorStage::setBrightness(uint8_t brightness) {
+
+  if (_built && brightness == _brightness)
+    return;
+
+  for (int i = 0; i < COLOR_STAGE_LEVELS; i++) {
+    // The level in 8.8 fixed point, gamma / 65535 * brightness
+    uint32_t value = ((uint32_t)gammaTable.values[i] * brightness + 128) >> 8;
+    uint8_t level = value >> 8;
+    uint8_t fraction = level == 255 ? 0 : value & 0xff;
+#if !LED_DITHER
+    level += fraction >> 7;             // round, there is no dither to carry the fraction
+#endif
+    _level[i] = level;
+    _fraction[i] = fraction;
+  }
+
+  _brightness = brightness;
+  _built = true;
+}
+
+void ColorStage::nextFrame() {
+
+  _frame++;
+
+  // Bit reversing the frame count spreads each fraction evenly over 256 frames.
+  uint8_t t = _frame;
+  t = (t & 0xf0) >> 4 | (t & 0x0f) << 4;
+  t = (t & 0xcc) >> 2 | (t & 0x33) << 2;
+  t = (t & 0xaa) >> 1 | (t & 0x55) << 1;
+  _threshold = t;
+}
+
+void ColorStage::correct(const CRGB *in, CRGB *out, uint16_t n, uint16_t firstPixel) const {
+
+  for (uint16_t i = 0; i < n; i++) {
+    uint16_t pixel = firstPixel + i;
+    out[i].r = correct(in[i].r, pixel, 0);
+    out[i].g = correct(in[i].g, pixel, 1);
+    out[i].b = correct(in[i].b, pixel, 2);
+  }
+}
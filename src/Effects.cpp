@@ -0,0 +1,531 @@
+/**
+ * @file Effects.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The light effects and the registry used to run them.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each effect keeps its state in its own struct, set back to the start by its
+ * reset hook whenever the effect is selected.  Render functions draw one step
+ * into the buffer they are given; the registry decides when a step is due.
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "XmasLights.h"
+#include "LedOutput.h"
+#include "PixelOps.h"
+#include "FastRandom.h"
+#include "BakedPatterns.h"
+#include "ShowClock.h"
+#include "Effects.h"
+
+int currentEffectNbr = 0;
+static uint32_t nextStep_ms = 0;
+
+/** The effect being faded out, drawing into its own frame, while a transition runs. */
+#if !LED_INDEXED_FRAME
+alignas(4) static CRGB outgoingFrame[NUMBER_OF_LIGHTS];
+#endif
+static int outgoingEffectNbr = -1;
+static uint32_t outgoingNextStep_ms = 0;
+static uint32_t transitionStart_ms = 0;
+
+/** The current and outgoing effects' power, from their models when selected, 0 without one. */
+static uint32_t currentPower_mW = 0;
+static uint32_t outgoingPower_mW = 0;
+
+/** The string length as a type of its own.  The live effects are templates
+ * on the type of their length, so besides the copy taking any length as a
+ * uint16_t each has one for the installation's NUMBER_OF_LIGHTS with the
+ * length folded into its loop bounds, divisions and modulos.  The pattern
+ * sizes come from the installation header and are constants already.
+ */
+template <uint16_t NBR_LEDS> struct FixedLength {
+  constexpr operator uint16_t() const { return NBR_LEDS; }
+};
+
+/** Draw with the copy specialised for NBR_LEDS whenever that's the length asked for. */
+template <uint16_t NBR_LEDS, void (*FIXED)(CRGB *, FixedLength<NBR_LEDS>), void (*ANY)(CRGB *, uint16_t)>
+static void renderFor(CRGB *leds, uint16_t nbrLEDS) {
+  if (nbrLEDS == NBR_LEDS)
+    FIXED(leds, FixedLength<NBR_LEDS>());
+  else
+    ANY(leds, nbrLEDS);
+}
+
+#define SPECIALISED(render) renderFor<NUMBER_OF_LIGHTS, render<FixedLength<NUMBER_OF_LIGHTS>>, render<uint16_t>>
+
+/** Comet */
+static const int cometSize = 10;
+static const int cometFadeAmt = 64;
+static const HSVHue cometHue = HUE_ORANGE;
+
+static struct CometState {
+  int iDirection;
+  int iPos;
+} comet;
+
+static void cometReset() {
+  comet.iDirection = 1;
+  comet.iPos = 0;
+}
+
+template <typename LENGTH> static void cometStep(LENGTH nbrOfLEDS) {
+
+  comet.iPos += comet.iDirection;
+
+  if (comet.iPos == (nbrOfLEDS - cometSize) || comet.iPos == 0)
+    comet.iDirection *= -1;
+}
+
+template <typename LENGTH> static void cometRender(CRGB *leds, LENGTH nbrOfLEDS) {
+
+  cometStep(nbrOfLEDS);
+
+  for (int i = 0; i < cometSize; i++)
+    leds[comet.iPos + i].setHue(cometHue);
+
+  // Each pixel fades on a coin flip, one 32 bit draw covers 32 pixels.
+  for (int j = 0; j < nbrOfLEDS; j += 32)
+    fadePixelsMasked(leds + j, min(32, nbrOfLEDS - j), cometFadeAmt, fastRandom.next32());
+}
+
+/** The indexed comet uses the palette as a fade ramp, the full colour at the
+ * top entry down to black at 0, so a fade is one step down the ramp.
+ */
+static void cometRenderIndexed(IndexedFrame &frame, uint16_t nbrOfLEDS) {
+
+  const uint8_t head = INDEXED_PALETTE_SIZE - 1;
+
+  CRGB color;
+  color.setHue(cometHue);
+  for (uint8_t k = head; k > 0; k--) {
+    frame.palette[k] = color;
+    color.nscale8(255 - cometFadeAmt);
+  }
+  frame.palette[0] = CRGB::Black;
+
+  cometStep(nbrOfLEDS);
+
+  for (int i = 0; i < cometSize; i++)
+    frame.set(comet.iPos + i, head);
+
+  uint32_t coins = 0;
+  for (int j = 0; j < nbrOfLEDS; j++) {
+    if ((j & 31) == 0)
+      coins = fastRandom.next32();
+    uint8_t k = frame.get(j);
+    if ((coins & 1) && k > 0)
+      frame.set(j, k - 1);
+    coins >>= 1;
+  }
+}
+
+/** Sparkle  */
+static const unsigned int nbrOfSparkleColors = 6;
+
+static const CRGB sparkleColors [nbrOfSparkleColors] =
+{
+  CRGB::Red,
+  CRGB::Blue,
+  CRGB::Purple,
+  CRGB::Black,
+  CRGB::Green,
+  CRGB::Orange
+};
+
+template <typename LENGTH> static void sparkleRender(CRGB *leds, LENGTH nbrOfLEDS) {
+  for (int i = 0; i < nbrOfLEDS; i++)
+    leds[i] = sparkleColors[fastRandom.below8(nbrOfSparkleColors)];
+}
+
+static void sparkleRenderIndexed(IndexedFrame &frame, uint16_t nbrOfLEDS) {
+  frame.setPalette(sparkleColors, nbrOfSparkleColors);
+  for (int i = 0; i < nbrOfLEDS; i++)
+    frame.set(i, fastRandom.below8(nbrOfSparkleColors));
+}
+
+/** Twinkle stars */
+static const unsigned int nbrOfTwinkleColors = 5;
+
+static const CRGB twinkleColors [nbrOfTwinkleColors] =
+{
+  CRGB::Red,
+  CRGB::Blue,
+  CRGB::Purple,
+  CRGB::Green,
+  CRGB::Orange
+};
+
+static struct TwinkleState {
+  unsigned int passCount;
+} twinkle;
+
+static void twinkleReset() {
+  twinkle.passCount = 0;
+}
+
+template <typename LENGTH> static void twinkleRender(CRGB *leds, LENGTH nbrOfLEDS) {
+
+  twinkle.passCount++;
+
+  if (twinkle.passCount == nbrOfLEDS / 4)
+  {
+    twinkle.passCount = 0;
+    fillPixels(leds, nbrOfLEDS, CRGB::Black);
+  }
+
+  leds[fastRandom.below16(nbrOfLEDS)] = twinkleColors[fastRandom.below8(nbrOfTwinkleColors)];
+}
+
+/** Indexed, the twinkle colours follow black in palette entry 0. */
+static void twinkleRenderIndexed(IndexedFrame &frame, uint16_t nbrOfLEDS) {
+
+  frame.palette[0] = CRGB::Black;
+  frame.setPalette(twinkleColors, nbrOfTwinkleColors, 1);
+
+  twinkle.passCount++;
+
+  if (twinkle.passCount == nbrOfLEDS / 4)
+  {
+    twinkle.passCount = 0;
+    frame.fill(0);
+  }
+
+  frame.set(fastRandom.below16(nbrOfLEDS), 1 + fastRandom.below8(nbrOfTwinkleColors));
+}
+
+/** Green and Red Train */
+static const unsigned int trainLength = TRAIN_CAR_LENGTH;
+
+static struct TrainState {
+  int offset;       // train position, advanced each step
+} train;
+
+static void trainReset() {
+  train.offset = 0;
+}
+
+template <typename LENGTH> static void trainRender(CRGB *leds, LENGTH nbrLEDS) {
+
+  fillPixels(leds, nbrLEDS, CRGB::Black);
+  for (int j = 0; j < trainLength; j++) {
+    if ((j + train.offset) < nbrLEDS) {
+      leds[j + train.offset] = CRGB::DarkRed;
+    }
+    if ((j + trainLength + train.offset) < nbrLEDS) {
+      leds[j + trainLength + train.offset] = CRGB::DarkGreen;
+    }
+  }
+
+  train.offset = (train.offset + 1) % nbrLEDS;
+}
+
+/** Rotating candy cane - move the candy cane one step every time we're called
+ *
+ * @note While safe to call with any width strip, to avoid artifacts the
+ * nbrOfLEDS should be divisible by 2 * stripWidth.
+*/
+static const unsigned int candyStripeWidth = CANDY_STRIPE_WIDTH;
+static const CRGB candyColors[2] = { CRGB::Red, CRGB::White };
+
+static struct CandyCaneState {
+  CRGB pattern[2 * candyStripeWidth];   // one red and one white stripe
+  uint16_t phase;
+} candyCane;
+
+static void candyCaneReset() {
+  fillStripes(candyCane.pattern, candyColors, 2, candyStripeWidth);
+  candyCane.phase = 0;
+}
+
+template <typename LENGTH> static void candyCaneRender(CRGB *leds, LENGTH nbrLEDS) {
+  fillRotatingPattern(leds, nbrLEDS, candyCane.pattern, 2 * candyStripeWidth, candyCane.phase);
+  candyCane.phase = rotatePhase(candyCane.phase, 2 * candyStripeWidth);
+}
+
+/** Rotating American Flag
+ *
+ * @note As with the candy cane nbrOfLEDS should be divisible by 3 * stripeWidth.
+ */
+static const unsigned int flagStripeWidth = FLAG_STRIPE_WIDTH;
+static const CRGB flagColors[3] = { CRGB::DarkBlue, CRGB::White, CRGB::DarkRed };
+
+static struct FlagState {
+  CRGB pattern[3 * flagStripeWidth];
+  uint16_t phase;
+} flag;
+
+static void flagReset() {
+  fillStripes(flag.pattern, flagColors, 3, flagStripeWidth);
+  flag.phase = 0;
+}
+
+template <typename LENGTH> static void redWhiteBlueRender(CRGB *leds, LENGTH nbrLEDS) {
+  fillRotatingPattern(leds, nbrLEDS, flag.pattern, 3 * flagStripeWidth, flag.phase);
+  flag.phase = rotatePhase(flag.phase, 3 * flagStripeWidth);
+}
+
+/** Baked train, candy cane and flag - the same pictures as the live versions
+ * above, drawn from one period in flash (see BakedPatterns.h).  Picked over
+ * the live ones by BAKED_EFFECTS.
+ */
+static const CRGB trainPalette[BAKED_PALETTE_SIZE] = { CRGB::Black, CRGB::DarkRed, CRGB::DarkGreen, CRGB::Black };
+static constexpr BakedIndices<2 * trainLength> trainIndices = bakeStripes<2 * trainLength>(trainLength, 1);
+static constexpr BakedPattern trainBaked = { BAKED_SLIDE, 2 * trainLength, trainIndices.bytes, trainPalette };
+
+static const CRGB candyPalette[BAKED_PALETTE_SIZE] = { CRGB::Red, CRGB::White, CRGB::Black, CRGB::Black };
+static constexpr BakedIndices<2 * candyStripeWidth> candyIndices = bakeStripes<2 * candyStripeWidth>(candyStripeWidth);
+static constexpr BakedPattern candyCaneBaked = { BAKED_ROTATE, 2 * candyStripeWidth, candyIndices.bytes, candyPalette };
+
+static const CRGB flagPalette[BAKED_PALETTE_SIZE] = { CRGB::DarkBlue, CRGB::White, CRGB::DarkRed, CRGB::Black };
+static constexpr BakedIndices<3 * flagStripeWidth> flagIndices = bakeStripes<3 * flagStripeWidth>(flagStripeWidth);
+static constexpr BakedPattern flagBaked = { BAKED_ROTATE, 3 * flagStripeWidth, flagIndices.bytes, flagPalette };
+
+static constexpr bool useBaked = BAKED_EFFECTS || LED_INDEXED_FRAME;   // the indexed versions are always baked
+
+/** Each pattern's position, its own as the outgoing and incoming effects of a crossfade both run. */
+template <const BakedPattern &PATTERN> struct BakedState {
+  static uint16_t position;
+};
+
+template <const BakedPattern &PATTERN> uint16_t BakedState<PATTERN>::position = 0;
+
+template <const BakedPattern &PATTERN> static void bakedReset() {
+  BakedState<PATTERN>::position = 0;
+}
+
+template <const BakedPattern &PATTERN> static void bakedRender(CRGB *leds, uint16_t nbrLEDS) {
+  uint16_t &position = BakedState<PATTERN>::position;
+  renderBakedPattern(leds, nbrLEDS, PATTERN, position);
+  position = nextBakedPosition(PATTERN, position, nbrLEDS);
+}
+
+template <const BakedPattern &PATTERN> static void bakedRenderIndexed(IndexedFrame &frame, uint16_t nbrLEDS) {
+  uint16_t &position = BakedState<PATTERN>::position;
+  renderBakedPattern(frame, nbrLEDS, PATTERN, position);
+  position = nextBakedPosition(PATTERN, position, nbrLEDS);
+}
+
+/** The baked pattern's power model, which holds for the live version too as it draws the same picture. */
+template <const BakedPattern &PATTERN> static uint32_t bakedPower(uint16_t nbrLEDS) {
+  return bakedPatternPower_mW(PATTERN, nbrLEDS);
+}
+
+/** random green and red */
+template <typename LENGTH> static void randomGreenAndRedRender(CRGB *leds, LENGTH nbrLEDS) {
+  for (int i = 0; i < nbrLEDS; i++) {
+    leds[i] = fastRandom.below8(10) > 5 ? CRGB::DarkRed : CRGB::DarkGreen;
+  }
+}
+
+static const CRGB greenAndRed[2] = { CRGB::DarkGreen, CRGB::DarkRed };
+
+static void randomGreenAndRedRenderIndexed(IndexedFrame &frame, uint16_t nbrLEDS) {
+  frame.setPalette(greenAndRed, 2);
+  for (int i = 0; i < nbrLEDS; i++)
+    frame.set(i, fastRandom.below8(10) > 5 ? 1 : 0);
+}
+
+/** Effects without state to reset */
+static void noReset() {}
+
+/** The registry, in the order the effects are shown. */
+static constexpr Effect effects[] = {
+  { "Candy Cane",
+    useBaked ? bakedReset<candyCaneBaked> : candyCaneReset,
+    BAKED_EFFECTS ? bakedRender<candyCaneBaked> : SPECIALISED(candyCaneRender),
+    bakedRenderIndexed<candyCaneBaked>,                               500,
+    bakedPower<candyCaneBaked> },
+  { "Twinkle Star",
+    twinkleReset, SPECIALISED(twinkleRender),
+    twinkleRenderIndexed,                                             200,
+    NULL },
+  { "Comet",
+    cometReset, SPECIALISED(cometRender),
+    cometRenderIndexed,                                                50,
+    NULL },
+  { "Train",
+    useBaked ? bakedReset<trainBaked> : trainReset,
+    BAKED_EFFECTS ? bakedRender<trainBaked> : SPECIALISED(trainRender),
+    bakedRenderIndexed<trainBaked>,                                   100,
+    bakedPower<trainBaked> },
+  { "Sparkle",
+    noReset, SPECIALISED(sparkleRender),
+    sparkleRenderIndexed,                                             750,
+    NULL },
+  { "Red White and Blue",
+    useBaked ? bakedReset<flagBaked> : flagReset,
+    BAKED_EFFECTS ? bakedRender<flagBaked> : SPECIALISED(redWhiteBlueRender),
+    bakedRenderIndexed<flagBaked>,                                    500,
+    bakedPower<flagBaked> },
+  { "Random Green and Red",
+    noReset, SPECIALISED(randomGreenAndRedRender),
+    randomGreenAndRedRenderIndexed,                                   500,
+    NULL },
+};
+
+static constexpr uint8_t nbrOfEffects = sizeof(effects) / sizeof(effects[0]);
+
+uint8_t effectCount() {
+  return nbrOfEffects;
+}
+
+const Effect &getEffect(uint8_t effectNbr) {
+  return effects[effectNbr % nbrOfEffects];
+}
+
+const Effect &currentEffect() {
+  return effects[currentEffectNbr];
+}
+
+void selectEffect(uint8_t effectNbr) {
+
+  currentEffectNbr = effectNbr % nbrOfEffects;
+  effects[currentEffectNbr].reset();
+  clearFrame();
+  outgoingEffectNbr = -1;
+
+  const Effect &effect = effects[currentEffectNbr];
+  currentPower_mW = effect.power_mW ? effect.power_mW(NUMBER_OF_LIGHTS) : 0;
+
+  // Draw the first step straight away, the rest fall on the show clock's
+  // grid of frame intervals so controllers sharing the clock step together.
+  uint32_t now = showClock.now_ms();
+  nextStep_ms = now - now % effects[currentEffectNbr].frameInterval_ms;
+}
+
+void nextEffect() {
+  selectEffect(currentEffectNbr + 1);
+}
+
+void transitionToEffect(uint8_t effectNbr, const CRGB *frame, uint16_t nbrLEDS) {
+
+  effectNbr %= nbrOfEffects;
+
+  // Effects keep their state in statics, so an effect can't fade into itself.
+  if (EFFECT_TRANSITION_ms == 0 || effectNbr == currentEffectNbr || LED_INDEXED_FRAME) {
+    selectEffect(effectNbr);
+    return;
+  }
+
+#if !LED_INDEXED_FRAME
+  uint8_t outgoing = currentEffectNbr;
+  uint32_t outgoingNextStep = nextStep_ms;
+  uint32_t outgoingPower = currentPower_mW;
+  memcpy(outgoingFrame, frame, min(nbrLEDS, (uint16_t)NUMBER_OF_LIGHTS) * sizeof(CRGB));
+
+  selectEffect(effectNbr);
+
+  outgoingEffectNbr = outgoing;
+  outgoingNextStep_ms = outgoingNextStep;
+  outgoingPower_mW = outgoingPower;
+  transitionStart_ms = showClock.now_ms();
+#else
+  (void)frame;
+  (void)nbrLEDS;
+#endif
+}
+
+void transitionToEffect(uint8_t effectNbr, const IndexedFrame &frame) {
+  (void)frame;
+  selectEffect(effectNbr);
+}
+
+void endTransition() {
+  outgoingEffectNbr = -1;
+}
+
+const CRGB *transitionFrame() {
+#if !LED_INDEXED_FRAME
+  if (outgoingEffectNbr >= 0)
+    return outgoingFrame;
+#endif
+  return NULL;
+}
+
+uint16_t transitionWeight() {
+
+  uint32_t elapsed = showClock.now_ms() - transitionStart_ms;
+  if (outgoingEffectNbr < 0 || elapsed >= EFFECT_TRANSITION_ms)
+    return 256;
+  return (elapsed << 8) / EFFECT_TRANSITION_ms;
+}
+
+uint32_t effectPower_mW() {
+
+  if (outgoingEffectNbr < 0)
+    return currentPower_mW;
+  if (currentPower_mW == 0 || outgoingPower_mW == 0)
+    return 0;
+  return max(currentPower_mW, outgoingPower_mW);
+}
+
+/** Number of an effect's steps due, moving its schedule, nextStep, on past them. */
+static uint8_t stepsDue(const Effect &effect, uint32_t &nextStep) {
+
+  uint32_t now = showClock.now_ms();
+  uint16_t interval = effect.frameInterval_ms;
+
+  // A show clock moved back by sync - pick the grid up again from now.
+  if ((int32_t)(nextStep - now) > (int32_t)interval)
+    nextStep = now - now % interval;
+
+  // Late steps are caught up so the effect stays in step with the clock,
+  // but after a long stall we start again on the grid from now.
+  uint8_t steps = 0;
+  while ((int32_t)(now - nextStep) >= 0 && steps < EFFECT_MAX_CATCHUP_STEPS) {
+    nextStep += interval;
+    steps++;
+  }
+  if ((int32_t)(now - nextStep) >= 0)
+    nextStep = now - now % interval + interval;
+
+  return steps;
+}
+
+bool renderEffect(CRGB *leds, uint16_t nbrLEDS) {
+
+  const Effect &effect = effects[currentEffectNbr];
+  uint8_t steps = stepsDue(effect, nextStep_ms);
+  bool changed = steps > 0;
+
+  while (steps--)
+    effect.render(leds, nbrLEDS);
+
+#if !LED_INDEXED_FRAME
+  if (outgoingEffectNbr >= 0) {
+    // The outgoing effect only draws when its own step is due, but the blend moves on every frame.
+    const Effect &outgoing = effects[outgoingEffectNbr];
+    for (steps = stepsDue(outgoing, outgoingNextStep_ms); steps > 0; steps--)
+      outgoing.render(outgoingFrame, min(nbrLEDS, (uint16_t)NUMBER_OF_LIGHTS));
+    changed = true;
+
+    if (showClock.now_ms() - transitionStart_ms >= EFFECT_TRANSITION_ms)
+      outgoingEffectNbr = -1;
+  }
+#endif
+
+  // The models are for the whole string, a shorter frame is left to be costed.
+  if (changed)
+    markFrameDirty(nbrLEDS == NUMBER_OF_LIGHTS ? effectPower_mW() : 0);
+  return changed;
+}
+
+bool renderEffect(IndexedFrame &frame, uint16_t nbrLEDS) {
+
+  const Effect &effect = effects[currentEffectNbr];
+  uint8_t steps = stepsDue(effect, nextStep_ms);
+
+  if (!steps)
+    return false;
+
+  while (steps--)
+    effect.renderIndexed(frame, nbrLEDS);
+  markFrameDirty(nbrLEDS == NUMBER_OF_LIGHTS ? effectPower_mW() : 0);
+  return true;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file EventLog.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Binary event log, recorded anywhere and written out in idle time.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <Arduino.h>
+#include <WiFiNINA.h>
+
+#include "EventLog.h"
+
+#define LOG_UDP_MAGIC 0x474f4c58UL      // "XLOG"
+
+/** How each event is written out and how often it may be recorded. */
+struct LogEventInfo {
+  const char *format;         // printf format taking arg0 and arg1 as longs
+  uint16_t minInterval_ms;
+  bool ipAddress;             // arg0 is an IP address, going into the format as its four bytes
+};
+
+static const LogEventInfo eventInfo[NBR_OF_LOG_EVENTS] = {
+  { "Started, %ld pixels on %ld strings",         0,    false },
+  { "Connecting to WiFi, %ld attempts failed",    0,    false },
+  { "WiFi connected, IP %u.%u.%u.%u, RSSI %ld dBm", 0,  true },
+  { "WiFi connection failed, retrying in %ld ms", 0,    false },
+  { "WiFi connection lost",                       0,    false },
+  { "Frame overran, %ld us of %ld us",            1000, false },
+  { "Stream started",                             1000, false },
+  { "Stream stopped, %ld packets, %ld lost",      1000, false },
+  { "Show clock stepped %ld ms",                  1000, false },
+  { "Settings saved, save %ld",                   0,    false },
+};
+
+/** The head of each datagram broadcast with LOG_UDP, the records follow. */
+struct LogDatagramHeader {
+  uint32_t magic;
+  uint32_t dropped;           // records lost to a full ring so far
+  uint16_t records;
+  uint16_t reserved;
+};
+
+EventLog eventLog;
+
+void EventLog::log(LogEvent event, int32_t arg0, int32_t arg1) {
+
+  uint32_t now = millis();
+
+  if (_everLogged[event] && now - _last_ms[event] < eventInfo[event].minInterval_ms) {
+    if (_pending[event] < UINT16_MAX)
+      _pending[event]++;
+    _suppressed++;
+    return;
+  }
+
+  if (_count == LOG_RECORDS) {
+    _dropped++;
+    return;
+  }
+
+  LogRecord &record = _ring[_head];
+  record.time_ms = now;
+  record.event = event;
+  record.reserved = 0;
+  record.suppressed = _pending[event];
+  record.arg0 = arg0;
+  record.arg1 = arg1;
+
+  _head = (_head + 1) % LOG_RECORDS;
+  _count++;
+  _logged++;
+
+  _everLogged[event] = true;
+  _last_ms[event] = now;
+  _pending[event] = 0;
+}
+
+void EventLog::formatRecord(char *line, size_t size, const LogRecord &record) {
+
+  const LogEventInfo &info = eventInfo[record.event];
+
+  int length = snprintf(line, size, "%8lu ", (unsigned long)record.time_ms);
+  if (info.ipAddress) {
+    uint32_t ip = record.arg0;
+    length += snprintf(line + length, size - length, info.format,
+                       (unsigned)(ip & 0xff), (unsigned)((ip >> 8) & 0xff), (unsigned)((ip >> 16) & 0xff),
+                       (unsigned)(ip >> 24), (long)record.arg1);
+  } else {
+    length += snprintf(line + length, size - length, info.format, (long)record.arg0, (long)record.arg1);
+  }
+  length = min(length, (int)size - 1);
+
+  if (record.suppressed)
+    length += snprintf(line + length, size - length, " (+%u)", record.suppressed);
+  length = min(length, (int)size - 3);
+
+  strcpy(line + length, "\r\n");
+}
+
+void EventLog::drainToSerial() {
+
+  char line[LOG_LINE_SIZE];
+
+  // availableForWrite() over USB doesn't always say what a write will block
+  // on, so each call is also held to a few lines
+  for (uint8_t lines = 0; lines < LOG_SERIAL_LINES && _count > 0; lines++) {
+    formatRecord(line, sizeof(line), _ring[_tail]);
+    size_t length = strlen(line);
+    if ((size_t)Serial.availableForWrite() < length)
+      return;                             // the rest when Serial has caught up
+    Serial.write((const uint8_t *)line, length);
+    _tail = (_tail + 1) % LOG_RECORDS;
+    _count--;
+  }
+}
+
+void EventLog::drainToUdp(WiFiUDP &udp, IPAddress broadcast) {
+
+  if (_count == 0)
+    return;
+
+  // each udp.write() is a transfer to the NINA, so the datagram is put
+  // together here and handed over in one
+  static uint8_t datagram[sizeof(LogDatagramHeader) + LOG_UDP_RECORDS * sizeof(LogRecord)];
+
+  LogDatagramHeader header = { LOG_UDP_MAGIC, _dropped, (uint16_t)min(_count, (uint8_t)LOG_UDP_RECORDS), 0 };
+
+  memcpy(datagram, &header, sizeof(header));
+  for (uint16_t i = 0; i < header.records; i++)
+    memcpy(datagram + sizeof(header) + i * sizeof(LogRecord), &_ring[(_tail + i) % LOG_RECORDS], sizeof(LogRecord));
+
+  if (!udp.beginPacket(broadcast, LOG_UDP_PORT))
+    return;
+  udp.write(datagram, sizeof(header) + header.records * sizeof(LogRecord));
+  if (!udp.endPacket())
+    return;                               // try them again next time
+
+  _tail = (_tail + header.records) % LOG_RECORDS;
+  _count -= header.records;
+}
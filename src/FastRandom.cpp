@@ -0,0 +1,25 @@
+/**
+ * @file FastRandom.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Cheap random numbers for the per pixel effects.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "FastRandom.h"
+
+FastRandom fastRandom;
+
+void FastRandom::seedFromNoise() {
+
+  // The low bit of a floating analog pin is mostly noise, fold a few dozen
+  // readings together with the time we got here.
+  uint32_t seed = micros();
+  for (uint8_t i = 0; i < 32; i++)
+    seed = (seed << 1 | seed >> 31) ^ analogRead(A0);
+
+  setSeed(seed);
+}
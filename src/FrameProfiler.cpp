@@ -0,0 +1,80 @@
+/**
+ * @file FrameProfiler.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Time spent in each stage of the frame loop.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "FrameProfiler.h"
+
+static const char *const stageNames[NBR_OF_PROFILE_STAGES] = {
+  "render", "show", "stream", "sync", "mdns", "web", "wifi", "log", "idle"
+};
+
+const char *FrameProfiler::stageName(ProfileStage stage) {
+  return stageNames[stage];
+}
+
+uint32_t FrameProfiler::bucketLimit_us(uint8_t bucket) {
+  return bucket < PROFILE_HISTOGRAM_BUCKETS - 1 ? (uint32_t)PROFILE_FIRST_BUCKET_us << bucket : UINT32_MAX;
+}
+
+/** Histogram bucket for a duration, found by shifting as the M0+ has no count leading zeros. */
+static uint8_t bucketFor(uint32_t duration_us) {
+
+  uint8_t bucket = 0;
+  for (uint32_t limit = PROFILE_FIRST_BUCKET_us; duration_us >= limit && bucket < PROFILE_HISTOGRAM_BUCKETS - 1; limit <<= 1)
+    bucket++;
+  return bucket;
+}
+
+void FrameProfiler::startFrame() {
+  memset(_frame_us, 0, sizeof(_frame_us));
+  _lap_us = micros();
+}
+
+void FrameProfiler::lap(ProfileStage stage) {
+  uint32_t now = micros();
+  _frame_us[stage] += now - _lap_us;
+  _lap_us = now;
+}
+
+void FrameProfiler::endFrame(uint8_t effectNbr) {
+
+  if (_windowFrames == 0)
+    memset(_windowMin_us, 0xff, sizeof(_windowMin_us));
+
+  uint32_t busy_us = 0;
+  for (uint8_t i = 0; i < NBR_OF_PROFILE_STAGES; i++) {
+    uint32_t t = _frame_us[i];
+    _windowSum_us[i] += t;
+    if (t < _windowMin_us[i])
+      _windowMin_us[i] = t;
+    if (t > _windowMax_us[i])
+      _windowMax_us[i] = t;
+    if (i != PROFILE_IDLE)
+      busy_us += t;
+  }
+
+  if (effectNbr < PROFILE_MAX_EFFECTS) {
+    _histogram[effectNbr][bucketFor(busy_us)]++;
+    _histogramSum_us[effectNbr] += busy_us;
+  }
+
+  if (++_windowFrames < PROFILE_WINDOW_FRAMES)
+    return;
+
+  // Window complete - publish it and start the next one.
+  for (uint8_t i = 0; i < NBR_OF_PROFILE_STAGES; i++) {
+    _stats[i].min_us = _windowMin_us[i];
+    _stats[i].average_us = _windowSum_us[i] / _windowFrames;
+    _stats[i].max_us = _windowMax_us[i];
+    _windowSum_us[i] = 0;
+    _windowMax_us[i] = 0;
+  }
+  _windowFrames = 0;
+}
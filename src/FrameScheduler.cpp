@@ -0,0 +1,67 @@
+/**
+ * @file FrameScheduler.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Deadline based frame pacing for the LED loop.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note All comparisons against micros() are done on the signed difference so
+ * the scheduler keeps working across the ~71 minute micros() roll over.
+ */
+
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(uint32_t framePeriod_us) : _framePeriod_us(framePeriod_us) {}
+
+void FrameScheduler::beginFrame() {
+
+  uint32_t now = micros();
+
+  // First frame, or we fell more than a whole frame behind - start a fresh
+  // deadline from now rather than trying to catch up with a burst of frames.
+  if (!_started || (int32_t)(now - _deadline_us) > (int32_t)_framePeriod_us) {
+    _deadline_us = now;
+    _started = true;
+  }
+
+  _frameStart_us = now;
+  _deadline_us += _framePeriod_us;
+}
+
+uint32_t FrameScheduler::timeRemaining_us() const {
+
+  int32_t remaining = (int32_t)(_deadline_us - micros());
+  return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+bool FrameScheduler::endFrame() {
+
+  uint32_t now = micros();
+
+  _lastFrame_us = now - _frameStart_us;
+  if (_lastFrame_us > _worstFrame_us)
+    _worstFrame_us = _lastFrame_us;
+
+  bool overran = (int32_t)(now - _deadline_us) > 0;
+  if (overran) {
+    _overruns++;
+    return true;
+  }
+
+  while ((int32_t)(_deadline_us - micros()) > 0)
+    yield();
+
+  return false;
+}
+
+void FrameScheduler::setFramePeriod(uint32_t framePeriod_us) {
+  _framePeriod_us = framePeriod_us;
+}
+
+void FrameScheduler::resetStats() {
+  _overruns = 0;
+  _worstFrame_us = 0;
+  _lastFrame_us = 0;
+}
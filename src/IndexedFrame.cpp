@@ -0,0 +1,53 @@
+/**
+ * @file IndexedFrame.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief A frame of 4 bit palette indices, for strings too long for 3 bytes a pixel.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "IndexedFrame.h"
+
+void IndexedFrame::copyFrom(const IndexedFrame &frame) {
+  memcpy(palette, frame.palette, sizeof(palette));
+  memcpy(_indices, frame._indices, INDEXED_FRAME_BYTES(min(_nbrLEDS, frame._nbrLEDS)));
+}
+
+void IndexedFrame::expand(CRGB *leds, uint16_t first, uint16_t count) const {
+
+  uint16_t i = first;
+
+  // Odd first pixel on its own, then two pixels for every byte.
+  if ((i & 1) && count) {
+    *leds++ = palette[get(i++)];
+    count--;
+  }
+
+  const uint8_t *indices = _indices + (i >> 1);
+  for (; count >= 2; count -= 2) {
+    uint8_t pair = *indices++;
+    *leds++ = palette[pair & 0x0F];
+    *leds++ = palette[pair >> 4];
+  }
+
+  if (count)
+    *leds = palette[*indices & 0x0F];
+}
+
+void IndexedFrame::histogram(uint16_t counts[INDEXED_PALETTE_SIZE]) const {
+
+  memset(counts, 0, INDEXED_PALETTE_SIZE * sizeof(counts[0]));
+
+  const uint8_t *indices = _indices;
+  for (uint16_t n = _nbrLEDS >> 1; n > 0; n--) {
+    uint8_t pair = *indices++;
+    counts[pair & 0x0F]++;
+    counts[pair >> 4]++;
+  }
+
+  if (_nbrLEDS & 1)
+    counts[*indices & 0x0F]++;
+}
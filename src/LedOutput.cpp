@@ -0,0 +1,239 @@
+/**
+ * @file LedOutput.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Owns the LED frame buffer and decides when it is sent to the string.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include "XmasLights.h"
+#include "PowerTelemetry.h"
+#include "LedOutput.h"
+#include "PixelOps.h"
+#include "ColorStage.h"
+#include "Effects.h"
+
+#if LED_OUTPUT_SPI_DMA
+#include "Ws2812Dma.h"
+#endif
+
+#if LED_INDEXED_FRAME
+IndexedFrameBuffer<NUMBER_OF_LIGHTS> leds;                  // back buffer, effects render here
+static IndexedFrameBuffer<NUMBER_OF_LIGHTS> frontBuffer;    // the frame the backend is sending
+#else
+alignas(4) CRGBArray<NUMBER_OF_LIGHTS> leds;            // back buffer, effects render here
+alignas(4) static CRGB frontBuffer[NUMBER_OF_LIGHTS];   // the frame the backend is sending
+#endif
+
+#if LED_OUTPUT_SPI_DMA
+static const Ws2812DmaPort dmaPorts[LED_STRING_COUNT] = WS2812_DMA_PORTS;
+static uint8_t dmaBuffers[LED_STRING_COUNT][WS2812_DMA_BUFFER_SIZE(LEDS_PER_STRING)];
+static Ws2812Dma ledStrings[LED_STRING_COUNT];
+#else
+static constexpr uint8_t ledStringPins[LED_STRING_COUNT] = LED_STRING_PINS;
+
+static CRGB stringPixels[NUMBER_OF_LIGHTS];    // the front buffer after the colour stage, what FastLED sends
+
+/** FastLED needs each data pin as a template argument, so add the strings
+ * with a compile time loop over ledStringPins.
+ */
+template <uint8_t STRING> struct StringAdder {
+  static void add() {
+    StringAdder<STRING - 1>::add();
+    FastLED.addLeds<WS2812B, ledStringPins[STRING - 1], GRB>(stringPixels + (STRING - 1) * LEDS_PER_STRING,
+                                                             LEDS_PER_STRING);
+  }
+};
+
+template <> struct StringAdder<0> {
+  static void add() {}
+};
+#endif
+
+static bool frameDirty = true;          // leds has changed since it was last published
+static bool framePending = false;       // frontBuffer is waiting for the backend
+static uint8_t frontBrightness = 0;
+static uint32_t framePower_mW = 0;     // leds' power by its effect's model, 0 to cost its pixels
+static uint32_t lastShown_ms = 0;
+static uint32_t shownCount = 0;
+static uint32_t firstShown_ms = 0;
+static uint32_t skippedCount = 0;
+static uint32_t droppedCount = 0;
+static uint32_t transmitCost_us = 0;   // CPU time the last transmit() took
+
+static uint32_t fpsWindowStart_ms = 0;
+static uint16_t fpsWindowFrames = 0;
+static uint16_t fps = 0;
+
+/** True while any string is still sending the previous frame. */
+static bool outputBusy() {
+#if LED_OUTPUT_SPI_DMA
+  for (const Ws2812Dma &ledString : ledStrings)
+    if (ledString.busy())
+      return true;
+#endif
+  return false;
+}
+
+/** Send the front buffer through the colour stage at the given brightness, on whichever backend is built in. */
+static void transmit(uint8_t brightness) {
+
+  uint32_t started = micros();
+
+  colorStage.setBrightness(brightness);
+  colorStage.nextFrame();
+
+#if LED_OUTPUT_SPI_DMA
+  // Encode everything first so the strings start, and run, together.
+  for (unsigned int i = 0; i < LED_STRING_COUNT; i++)
+#if LED_INDEXED_FRAME
+    ledStrings[i].encode(frontBuffer, i * LEDS_PER_STRING, colorStage);
+#else
+    ledStrings[i].encode(frontBuffer + i * LEDS_PER_STRING, i * LEDS_PER_STRING, colorStage);
+#endif
+  for (Ws2812Dma &ledString : ledStrings)
+    ledString.start();
+#else
+#if LED_INDEXED_FRAME
+  frontBuffer.expand(stringPixels, 0, NUMBER_OF_LIGHTS);
+  colorStage.correct(stringPixels, stringPixels, NUMBER_OF_LIGHTS);
+#else
+  colorStage.correct(frontBuffer, stringPixels, NUMBER_OF_LIGHTS);
+#endif
+  FastLED.show(255);                    // brightness is already in the colour stage
+#endif
+
+  transmitCost_us = micros() - started;
+}
+
+/** Move the finished back buffer to the front so the next frame can be rendered over it.
+ *
+ * This is a copy rather than a pointer swap.  Effects such as comet and
+ * twinkleStar draw over their previous frame, so a swap would need the same
+ * copy to carry the frame over to the new back buffer.
+ */
+static void publishFrame() {
+  if (framePending)
+    droppedCount++;                     // the frame waiting to go out is never shown
+#if LED_INDEXED_FRAME
+  frontBuffer.copyFrom(leds);
+  if (framePower_mW)
+    frontBrightness = powerTelemetry.updateModelled(framePower_mW);
+  else
+    frontBrightness = powerTelemetry.update(frontBuffer);
+#else
+  // Mid transition the outgoing effect is blended in here, on the copy we make anyway.
+  const CRGB *outgoing = transitionFrame();
+  if (outgoing)
+    blendPixels(frontBuffer, outgoing, leds, NUMBER_OF_LIGHTS, transitionWeight());
+  else
+    memcpy(frontBuffer, leds, sizeof(frontBuffer));
+  if (framePower_mW)
+    frontBrightness = powerTelemetry.updateModelled(framePower_mW);
+  else
+    frontBrightness = powerTelemetry.update(frontBuffer, NUMBER_OF_LIGHTS);
+#endif
+  framePending = true;
+  frameDirty = false;
+}
+
+void beginLedOutput() {
+#if LED_OUTPUT_SPI_DMA
+  for (unsigned int i = 0; i < LED_STRING_COUNT; i++)
+    ledStrings[i].begin(dmaPorts[i], i, dmaBuffers[i], LEDS_PER_STRING);
+#else
+  StringAdder<LED_STRING_COUNT>::add();
+#endif
+  markFrameDirty();
+}
+
+void markFrameDirty(uint32_t modelledPower_mW) {
+  frameDirty = true;
+  framePower_mW = modelledPower_mW;
+}
+
+void clearFrame() {
+#if LED_INDEXED_FRAME
+  leds.fill(0);
+#else
+  fillPixels(leds, NUMBER_OF_LIGHTS, CRGB::Black);
+#endif
+  markFrameDirty();
+}
+
+bool showFrame() {
+
+  uint32_t now = millis();
+
+  if ((now - fpsWindowStart_ms) >= 1000) {
+    fps = fpsWindowFrames;
+    fpsWindowFrames = 0;
+    fpsWindowStart_ms = now;
+  }
+
+  if (frameDirty) {
+    // Frame boundary - a newer frame simply replaces one still waiting to go out.
+    publishFrame();
+  } else if (LED_DITHER && !framePending
+             && frameScheduler.timeRemaining_us() > transmitCost_us + NETWORK_POLL_RESERVE_us) {
+    // Re-send the unchanged frame to move the dither on, as long as this frame has room for it.
+    framePending = true;
+  } else if (!framePending && LED_REFRESH_INTERVAL_ms > 0 && (now - lastShown_ms) >= LED_REFRESH_INTERVAL_ms) {
+    // Keep alive - re-send the unchanged frame in case a pixel picked up a glitch.
+    framePending = true;
+  } else if (!framePending) {
+    skippedCount++;
+    return false;
+  }
+
+  return serviceLedOutput();
+}
+
+bool serviceLedOutput() {
+
+  if (!framePending)
+    return false;
+
+  if (outputBusy())
+    return false;                       // previous frame still going out
+
+  transmit(frontBrightness);
+
+  framePending = false;
+  lastShown_ms = millis();
+  if (shownCount++ == 0)
+    firstShown_ms = lastShown_ms;
+  fpsWindowFrames++;
+  return true;
+}
+
+void waitForLedOutput() {
+  while (framePending || outputBusy())
+    serviceLedOutput();
+}
+
+uint32_t framesShown() {
+  return shownCount;
+}
+
+uint32_t firstFrame_ms() {
+  return firstShown_ms;
+}
+
+uint32_t framesSkipped() {
+  return skippedCount;
+}
+
+uint32_t framesDropped() {
+  return droppedCount;
+}
+
+uint16_t outputFPS() {
+  return fps;
+}
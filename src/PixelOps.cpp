@@ -0,0 +1,164 @@
+/**
+ * @file PixelOps.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Frame buffer primitives shared by the effects.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "PixelOps.h"
+
+void fillStripes(CRGB *pattern, const CRGB *colors, uint8_t nbrOfColors, uint8_t stripeWidth) {
+
+  for (uint8_t c = 0; c < nbrOfColors; c++) {
+    fill_solid(pattern, stripeWidth, colors[c]);
+    pattern += stripeWidth;
+  }
+}
+
+void fillRotatingPattern(CRGB *leds, uint16_t nbrLEDS, const CRGB *pattern, uint16_t period, uint16_t phase) {
+
+  // First period straight from the pattern, in two runs either side of the phase.
+  uint16_t written = min((uint16_t)(period - phase), nbrLEDS);
+  memcpy(leds, pattern + phase, written * sizeof(CRGB));
+
+  uint16_t run = min(phase, (uint16_t)(nbrLEDS - written));
+  memcpy(leds + written, pattern, run * sizeof(CRGB));
+  written += run;
+
+  extendPeriodic(leds, nbrLEDS, written);
+}
+
+void extendPeriodic(CRGB *leds, uint16_t nbrLEDS, uint16_t written) {
+
+  // Everything written so far is whole periods, so keep doubling it.
+  while (written < nbrLEDS) {
+    uint16_t run = min(written, (uint16_t)(nbrLEDS - written));
+    memcpy(leds + written, leds, run * sizeof(CRGB));
+    written += run;
+  }
+}
+
+/** Byte lanes of the three words holding four pixels, indexed by a nibble
+ * with one bit per pixel.
+ */
+static constexpr uint32_t byteMask(uint8_t pixels, uint8_t byteNbr) {
+  return ((pixels >> (byteNbr / 3)) & 1) ? 0xFFUL << (8 * (byteNbr & 3)) : 0;
+}
+
+static constexpr uint32_t wordMask(uint8_t pixels, uint8_t wordNbr) {
+  return byteMask(pixels, 4 * wordNbr) | byteMask(pixels, 4 * wordNbr + 1) |
+         byteMask(pixels, 4 * wordNbr + 2) | byteMask(pixels, 4 * wordNbr + 3);
+}
+
+#define PIXEL_MASKS(p) { wordMask(p, 0), wordMask(p, 1), wordMask(p, 2) }
+
+static const uint32_t pixelMasks[16][3] = {
+  PIXEL_MASKS(0),  PIXEL_MASKS(1),  PIXEL_MASKS(2),  PIXEL_MASKS(3),
+  PIXEL_MASKS(4),  PIXEL_MASKS(5),  PIXEL_MASKS(6),  PIXEL_MASKS(7),
+  PIXEL_MASKS(8),  PIXEL_MASKS(9),  PIXEL_MASKS(10), PIXEL_MASKS(11),
+  PIXEL_MASKS(12), PIXEL_MASKS(13), PIXEL_MASKS(14), PIXEL_MASKS(15),
+};
+
+/** scale8() on all four bytes of a word, scale1 being scale + 1. */
+static inline uint32_t scaleWord(uint32_t word, uint32_t scale1) {
+  uint32_t even = (((word & 0x00FF00FF) * scale1) >> 8) & 0x00FF00FF;
+  uint32_t odd = (((word >> 8) & 0x00FF00FF) * scale1) & 0xFF00FF00;
+  return even | odd;
+}
+
+static inline bool wordAligned(const CRGB *leds) {
+  return ((uintptr_t)leds & 3) == 0;
+}
+
+void fillPixels(CRGB *leds, uint16_t nbrLEDS, const CRGB &color) {
+
+  if (!wordAligned(leds)) {
+    fill_solid(leds, nbrLEDS, color);
+    return;
+  }
+
+  // Four pixels of the colour, as they sit in three words.
+  CRGB four[4] = { color, color, color, color };
+  uint32_t pattern[3];
+  memcpy(pattern, four, sizeof(pattern));
+
+  uint32_t *word = (uint32_t *)leds;
+  uint16_t groups = nbrLEDS >> 2;
+  while (groups--) {
+    word[0] = pattern[0];
+    word[1] = pattern[1];
+    word[2] = pattern[2];
+    word += 3;
+  }
+
+  for (uint16_t i = nbrLEDS & ~3; i < nbrLEDS; i++)
+    leds[i] = color;
+}
+
+void scalePixels(CRGB *leds, uint16_t nbrLEDS, uint8_t scale) {
+
+  uint16_t i = 0;
+
+  if (wordAligned(leds)) {
+    uint32_t scale1 = scale + 1;
+    uint32_t *word = (uint32_t *)leds;
+    for (uint16_t n = (nbrLEDS >> 2) * 3; n > 0; n--, word++)
+      *word = scaleWord(*word, scale1);
+    i = nbrLEDS & ~3;
+  }
+
+  for (; i < nbrLEDS; i++)
+    leds[i].nscale8(scale);
+}
+
+void blendPixels(CRGB *out, const CRGB *from, const CRGB *to, uint16_t nbrLEDS, uint16_t weight) {
+
+  uint16_t i = 0;
+  uint32_t fromWeight = 256 - weight;
+
+  if (wordAligned(out) && wordAligned(from) && wordAligned(to)) {
+    const uint32_t *fromWord = (const uint32_t *)from;
+    const uint32_t *toWord = (const uint32_t *)to;
+    uint32_t *outWord = (uint32_t *)out;
+    for (uint16_t n = (nbrLEDS >> 2) * 3; n > 0; n--) {
+      uint32_t f = *fromWord++;
+      uint32_t t = *toWord++;
+      uint32_t even = (((f & 0x00FF00FF) * fromWeight + (t & 0x00FF00FF) * weight) >> 8) & 0x00FF00FF;
+      uint32_t odd = (((f >> 8) & 0x00FF00FF) * fromWeight + ((t >> 8) & 0x00FF00FF) * weight) & 0xFF00FF00;
+      *outWord++ = even | odd;
+    }
+    i = nbrLEDS & ~3;
+  }
+
+  for (; i < nbrLEDS; i++) {
+    out[i].r = (from[i].r * fromWeight + to[i].r * weight) >> 8;
+    out[i].g = (from[i].g * fromWeight + to[i].g * weight) >> 8;
+    out[i].b = (from[i].b * fromWeight + to[i].b * weight) >> 8;
+  }
+}
+
+void fadePixelsMasked(CRGB *leds, uint8_t nbrLEDS, uint8_t fadeAmt, uint32_t mask) {
+
+  uint8_t scale = 255 - fadeAmt;
+  uint8_t i = 0;
+
+  if (wordAligned(leds)) {
+    uint32_t scale1 = scale + 1;
+    uint32_t *word = (uint32_t *)leds;
+    for (; i + 4 <= nbrLEDS; i += 4, word += 3, mask >>= 4) {
+      const uint32_t *lanes = pixelMasks[mask & 0x0F];
+      if (lanes == pixelMasks[0])
+        continue;
+      for (uint8_t w = 0; w < 3; w++)
+        word[w] = (word[w] & ~lanes[w]) | (scaleWord(word[w], scale1) & lanes[w]);
+    }
+  }
+
+  for (; i < nbrLEDS; i++, mask >>= 1)
+    if (mask & 1)
+      leds[i].nscale8(scale);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file PixelOpsBenchmark.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Timing of the word wide pixel functions against FastLED's per pixel calls.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Built with the nano_33_iot_pixelops_bench environment, which runs it once
+ * from setup() and prints the results to Serial.
+ */
+
+#include "PixelOps.h"
+
+#if PIXELOPS_BENCHMARK
+
+#include "XmasLights.h"
+#include "FastRandom.h"
+#include "Benchmark.h"
+
+#define PIXELOPS_BENCHMARK_MAX_LEDS 1200
+#define PIXELOPS_BENCHMARK_REPEATS 20
+
+alignas(4) static CRGB benchLeds[PIXELOPS_BENCHMARK_MAX_LEDS];
+static const uint16_t benchSizes[] = { 150, 600, PIXELOPS_BENCHMARK_MAX_LEDS };
+
+static const uint8_t benchFadeAmt = 64;
+static const CRGB benchColor = CRGB::Orange;
+
+static void fillRandom(uint16_t nbrLEDS) {
+  for (uint16_t i = 0; i < nbrLEDS; i++)
+    benchLeds[i] = CRGB(fastRandom.bits(8), fastRandom.bits(8), fastRandom.bits(8));
+}
+
+/** Per pixel comet fade the way it was written before fadePixelsMasked(). */
+static void fastLEDMaskedFade(uint16_t nbrLEDS) {
+  uint32_t coins = 0;
+  for (uint16_t j = 0; j < nbrLEDS; j++) {
+    if ((j & 31) == 0)
+      coins = fastRandom.next32();
+    if (coins & 1)
+      benchLeds[j].fadeToBlackBy(benchFadeAmt);
+    coins >>= 1;
+  }
+}
+
+static void pixelOpsMaskedFade(uint16_t nbrLEDS) {
+  for (uint16_t j = 0; j < nbrLEDS; j += 32)
+    fadePixelsMasked(benchLeds + j, min(32, nbrLEDS - j), benchFadeAmt, fastRandom.next32());
+}
+
+/** Average microseconds for one call of op over the first nbrLEDS pixels. */
+template <typename Op> static uint32_t timeOp(uint16_t nbrLEDS, Op op) {
+
+  fastRandom.setSeed(1);
+  fillRandom(nbrLEDS);
+
+  uint32_t started = micros();
+  for (uint8_t i = 0; i < PIXELOPS_BENCHMARK_REPEATS; i++)
+    op(nbrLEDS);
+  return (micros() - started) / PIXELOPS_BENCHMARK_REPEATS;
+}
+
+static void report(const char *name, uint16_t nbrLEDS, uint32_t fastLED_us, uint32_t pixelOps_us) {
+  BENCHMARK_PRINTF("%-12s %5u LEDs  FastLED %6lu us  PixelOps %6lu us\n", name, nbrLEDS,
+      (unsigned long)fastLED_us, (unsigned long)pixelOps_us);
+}
+
+void benchmarkPixelOps() {
+
+  BENCHMARK_PRINTF("PixelOps benchmark, average of %u calls\n", PIXELOPS_BENCHMARK_REPEATS);
+
+  for (uint16_t nbrLEDS : benchSizes) {
+    report("fill", nbrLEDS,
+           timeOp(nbrLEDS, [](uint16_t n) { fill_solid(benchLeds, n, benchColor); }),
+           timeOp(nbrLEDS, [](uint16_t n) { fillPixels(benchLeds, n, benchColor); }));
+    report("scale", nbrLEDS,
+           timeOp(nbrLEDS, [](uint16_t n) { nscale8(benchLeds, n, 255 - benchFadeAmt); }),
+           timeOp(nbrLEDS, [](uint16_t n) { scalePixels(benchLeds, n, 255 - benchFadeAmt); }));
+    report("fade", nbrLEDS,
+           timeOp(nbrLEDS, [](uint16_t n) { fadeToBlackBy(benchLeds, n, benchFadeAmt); }),
+           timeOp(nbrLEDS, [](uint16_t n) { fadePixels(benchLeds, n, benchFadeAmt); }));
+    report("masked fade", nbrLEDS,
+           timeOp(nbrLEDS, fastLEDMaskedFade),
+           timeOp(nbrLEDS, pixelOpsMaskedFade));
+  }
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file PowerTelemetry.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Per frame power estimate, power limiting and windowed power statistics.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note Everything here is integer math, the SAMD21 has no FPU.  The limiter
+ * follows FastLED's calculate_max_brightness_for_power_mW(), but on the
+ * channels after gamma, which are what FastLED.show() never sees.
+ */
+
+#include "PowerTelemetry.h"
+
+PowerTelemetry::PowerTelemetry(uint8_t targetBrightness, uint32_t maxPower_mW)
+  : _targetBrightness(targetBrightness), _maxPower_mW(maxPower_mW), _brightness(targetBrightness) {}
+
+void PowerTelemetry::setIndicatorPin(int pin) {
+  _indicatorPin = pin;
+  _indicatorOn = false;
+  digitalWrite(_indicatorPin, LOW);
+}
+
+uint8_t PowerTelemetry::update(const CRGB *leds, uint16_t nbrLEDS) {
+
+  PixelPower power;
+  for (uint16_t i = 0; i < nbrLEDS; i++)
+    power.add(leds[i]);
+
+  return limit(power.unscaled_mW());
+}
+
+uint8_t PowerTelemetry::update(const IndexedFrame &frame) {
+
+  uint16_t counts[INDEXED_PALETTE_SIZE];
+  frame.histogram(counts);
+
+  // The same sums as a full colour frame, weighted by the counts.
+  PixelPower power;
+  for (uint8_t i = 0; i < INDEXED_PALETTE_SIZE; i++)
+    power.add(frame.palette[i], counts[i]);
+
+  return limit(power.unscaled_mW());
+}
+
+uint8_t PowerTelemetry::updateModelled(uint32_t unscaled_mW) {
+
+  if (!_modelledValid || _modelled.unscaled_mW != unscaled_mW) {
+    _modelled = scaleFor(unscaled_mW);
+    _modelledValid = true;
+  }
+
+  return apply(_modelled);
+}
+
+PowerTelemetry::PowerScale PowerTelemetry::scaleFor(uint32_t unscaled_mW) const {
+
+  PowerScale scale;
+  scale.unscaled_mW = unscaled_mW;
+
+  unscaled_mW += POWER_MCU_mW;
+  scale.requested_mW = (unscaled_mW * _targetBrightness) / 256;
+  scale.limited = scale.requested_mW > _maxPower_mW;
+  scale.brightness = scale.limited ? (_targetBrightness * _maxPower_mW) / scale.requested_mW : _targetBrightness;
+  scale.shown_mW = (unscaled_mW * scale.brightness) / 256;
+
+  return scale;
+}
+
+uint8_t PowerTelemetry::apply(const PowerScale &scale) {
+
+  _brightness = scale.brightness;
+  _frame_mW = scale.shown_mW;
+
+  if (_indicatorPin >= 0 && scale.limited != _indicatorOn) {
+    _indicatorOn = scale.limited;
+    digitalWrite(_indicatorPin, scale.limited ? HIGH : LOW);
+  }
+
+  record(scale.requested_mW, scale.shown_mW, scale.limited);
+
+  return _brightness;
+}
+
+void PowerTelemetry::record(uint32_t requested_mW, uint32_t shown_mW, bool limited) {
+
+  _windowFrames++;
+  _windowSum_mW += shown_mW;
+  if (limited)
+    _windowLimited++;
+  if (shown_mW < _windowMin_mW)
+    _windowMin_mW = shown_mW;
+  if (shown_mW > _windowMax_mW)
+    _windowMax_mW = shown_mW;
+  if (requested_mW > _windowPeakRequested_mW)
+    _windowPeakRequested_mW = requested_mW;
+
+  if (_windowFrames < POWER_WINDOW_FRAMES)
+    return;
+
+  // Window complete - publish it and start the next one.
+  _min_mW = _windowMin_mW;
+  _max_mW = _windowMax_mW;
+  _average_mW = _windowSum_mW / _windowFrames;
+  _limitedPercent = (_windowLimited * 100) / _windowFrames;
+  _peakDemandPercent = _maxPower_mW ? min((_windowPeakRequested_mW * 100) / _maxPower_mW, (uint32_t)UINT16_MAX) : 0;
+
+  _windowFrames = 0;
+  _windowLimited = 0;
+  _windowSum_mW = 0;
+  _windowMin_mW = UINT32_MAX;
+  _windowMax_mW = 0;
+  _windowPeakRequested_mW = 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file Settings.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Settings kept in the SAMD21's own flash, changed without a rebuild.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <stddef.h>
+
+#include "XmasLights.h"
+#include "Effects.h"
+#include "PowerTelemetry.h"
+#include "EventLog.h"
+#include "Settings.h"
+
+#define SETTINGS_MAGIC 0x54455358UL                   // "XSET"
+#define SETTINGS_PAGE_SIZE 64                         // NVM page, the most written at once
+#define SETTINGS_ROW_SIZE (4 * SETTINGS_PAGE_SIZE)    // NVM row, the least erased at once
+#define SETTINGS_SLOT_SIZE (2 * SETTINGS_PAGE_SIZE)
+#define SETTINGS_SLOTS (SETTINGS_ROWS * SETTINGS_ROW_SIZE / SETTINGS_SLOT_SIZE)
+
+/** A slot as written, the header and then the block. */
+struct SettingsRecord {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length;              // bytes of block that follow
+  uint32_t sequence;            // one more than the save before
+  uint32_t crc;                 // CRC-32 of the fields above and length bytes of block
+  SettingsBlock block;
+};
+
+union SettingsSlot {
+  SettingsRecord record;
+  uint32_t words[SETTINGS_SLOT_SIZE / 4];
+};
+
+static_assert(sizeof(SettingsRecord) <= SETTINGS_SLOT_SIZE, "the settings don't fit in a slot");
+static_assert(SETTINGS_ROWS >= 2, "a save erases a row, the current settings need to be in another");
+
+/** The rows themselves, in the sketch's flash.  They're only read through a
+ * volatile pointer, so the compiler can't fold in the zeros they start as.
+ */
+__attribute__((aligned(SETTINGS_ROW_SIZE))) static const uint8_t settingsFlash[SETTINGS_ROWS * SETTINGS_ROW_SIZE] = { };
+
+Settings settings;
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t length) {
+
+  crc = ~crc;
+  while (length--) {
+    crc ^= *data++;
+    for (uint8_t k = 0; k < 8; k++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+static uint32_t recordCrc(const SettingsRecord &record) {
+  uint32_t crc = crc32(0, (const uint8_t *)&record, offsetof(SettingsRecord, crc));
+  return crc32(crc, (const uint8_t *)&record.block, record.length);
+}
+
+static volatile uint32_t *slotAddress(int slot) {
+  return (volatile uint32_t *)(settingsFlash + slot * SETTINGS_SLOT_SIZE);
+}
+
+static void readSlot(int slot, SettingsSlot &contents) {
+  const volatile uint32_t *flash = slotAddress(slot);
+  for (uint8_t i = 0; i < SETTINGS_SLOT_SIZE / 4; i++)
+    contents.words[i] = flash[i];
+}
+
+/** A slot holds settings if it has a whole record from this build or an older one. */
+static bool isSaved(const SettingsSlot &contents) {
+  const SettingsRecord &record = contents.record;
+  return record.magic == SETTINGS_MAGIC
+      && record.version <= SETTINGS_VERSION
+      && record.length <= SETTINGS_SLOT_SIZE - offsetof(SettingsRecord, block)
+      && record.crc == recordCrc(record);
+}
+
+/** Run an NVM controller command on the row or page at address and wait for it. */
+static void nvmCommand(uint16_t command, volatile uint32_t *address) {
+  NVMCTRL->STATUS.reg |= NVMCTRL_STATUS_MASK;           // clear any earlier error
+  NVMCTRL->ADDR.reg = (uintptr_t)address / 2;           // in 16 bit words
+  NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | command;
+  while (!NVMCTRL->INTFLAG.bit.READY)
+    ;
+}
+
+/** Write a slot, erasing its row first if it's the first slot in it. */
+static void writeSlot(int slot, const SettingsSlot &contents) {
+
+  volatile uint32_t *flash = slotAddress(slot);
+
+  NVMCTRL->CTRLB.bit.MANW = 1;                          // pages are written by command, not on the last word
+  if ((slot * SETTINGS_SLOT_SIZE) % SETTINGS_ROW_SIZE == 0)
+    nvmCommand(NVMCTRL_CTRLA_CMD_ER, flash);
+
+  for (uint8_t page = 0; page < SETTINGS_SLOT_SIZE / SETTINGS_PAGE_SIZE; page++) {
+    volatile uint32_t *pageAddress = flash + page * (SETTINGS_PAGE_SIZE / 4);
+    nvmCommand(NVMCTRL_CTRLA_CMD_PBC, pageAddress);
+    for (uint8_t i = 0; i < SETTINGS_PAGE_SIZE / 4; i++)
+      pageAddress[i] = contents.words[page * (SETTINGS_PAGE_SIZE / 4) + i];   // into the page buffer
+    nvmCommand(NVMCTRL_CTRLA_CMD_WP, pageAddress);
+  }
+}
+
+Settings::Settings() : _current(defaults()), _sequence(0), _slot(-1) {
+}
+
+void Settings::begin() {
+
+  SettingsSlot contents;
+
+  for (int slot = 0; slot < SETTINGS_SLOTS; slot++) {
+    readSlot(slot, contents);
+    if (isSaved(contents) && (_slot < 0 || (int32_t)(contents.record.sequence - _sequence) > 0)) {
+      _slot = slot;
+      _sequence = contents.record.sequence;
+    }
+  }
+
+  if (_slot < 0)
+    return;
+
+  // Fields the block was saved without keep their defaults.
+  readSlot(_slot, contents);
+  SettingsBlock block = defaults();
+  memcpy(&block, &contents.record.block, min((size_t)contents.record.length, sizeof(block)));
+  if (isValid(block))
+    _current = block;
+}
+
+bool Settings::save(const SettingsBlock &block) {
+
+  if (!isValid(block))
+    return false;
+  if (memcmp(&block, &_current, sizeof(block)) == 0)
+    return true;
+
+  SettingsSlot contents;
+  memset(&contents, 0xff, sizeof(contents));            // as erased, for the rest of the slot
+  contents.record.magic = SETTINGS_MAGIC;
+  contents.record.version = SETTINGS_VERSION;
+  contents.record.length = sizeof(block);
+  contents.record.sequence = _sequence + 1;
+  contents.record.block = block;
+  contents.record.crc = recordCrc(contents.record);
+
+  int slot = (_slot + 1) % SETTINGS_SLOTS;
+  writeSlot(slot, contents);
+
+  SettingsSlot written;
+  readSlot(slot, written);
+  if (memcmp(&written, &contents, sizeof(written)) != 0)
+    return false;
+
+  _current = block;
+  _slot = slot;
+  _sequence = contents.record.sequence;
+  eventLog.log(LOG_SETTINGS_SAVED, _sequence);
+  return true;
+}
+
+SettingsBlock Settings::defaults() {
+
+  SettingsBlock block;
+  memset(&block, 0, sizeof(block));
+  strncpy(block.hostname, HOSTNAME, sizeof(block.hostname) - 1);
+  block.maxPower_mW = MAX_POWER_mW;
+  block.brightness = LED_BRIGHTNESS;
+  return block;
+}
+
+bool Settings::isValid(const SettingsBlock &block) {
+
+  // The host name goes into DHCP and mDNS, so letters, digits, '-' and '_' only.
+  size_t length = strnlen(block.hostname, sizeof(block.hostname));
+  if (length == 0 || length == sizeof(block.hostname))
+    return false;
+  for (size_t i = 0; i < length; i++) {
+    char c = block.hostname[i];
+    if (!isalnum((unsigned char)c) && c != '-' && c != '_')
+      return false;
+  }
+
+  if (block.brightness == 0 || block.maxPower_mW == 0 || block.effectCount > SETTINGS_MAX_EFFECTS)
+    return false;
+  for (uint8_t i = 0; i < block.effectCount; i++)
+    if (block.effectOrder[i] >= effectCount())
+      return false;
+
+  return true;
+}
+
+void applySettings() {
+  powerTelemetry.setTargetBrightness(settings.current().brightness);
+  powerTelemetry.setMaxPower_mW(settings.current().maxPower_mW);
+}
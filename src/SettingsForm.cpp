@@ -0,0 +1,122 @@
+/**
+ * @file SettingsForm.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Settings changes sent as a urlencoded form.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <Arduino.h>
+#include <ctype.h>
+
+#include "SettingsForm.h"
+
+/** A decimal number filling all of text, which isn't NUL terminated. */
+static bool parseNumber(const char *text, size_t length, uint32_t &value) {
+
+  value = 0;
+  if (length == 0 || length > 9)
+    return false;
+  for (size_t i = 0; i < length; i++) {
+    if (!isdigit(text[i]))
+      return false;
+    value = value * 10 + (text[i] - '0');
+  }
+  return true;
+}
+
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c = tolower(c);
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/** Undo a value's %XX escapes and its '+' for a space, into into.
+ *
+ * @returns the decoded length, or -1 for a broken escape or a value too long
+ * for into.
+ */
+static int decodeValue(const char *value, size_t length, char *into, size_t size) {
+
+  size_t decoded = 0;
+
+  for (size_t i = 0; i < length; i++) {
+    if (decoded == size)
+      return -1;
+    char c = value[i];
+    if (c == '+') {
+      c = ' ';
+    } else if (c == '%') {
+      if (length - i < 3)
+        return -1;
+      int high = hexDigit(value[i + 1]), low = hexDigit(value[i + 2]);
+      if (high < 0 || low < 0)
+        return -1;
+      c = (char)(high << 4 | low);
+      i += 2;
+    }
+    into[decoded++] = c;
+  }
+  return decoded;
+}
+
+bool parseSettingsForm(const char *form, SettingsBlock &block) {
+
+  char text[SETTINGS_FORM_VALUE_SIZE];
+
+  while (*form) {
+    const char *end = form + strcspn(form, "&");
+    const char *equals = (const char *)memchr(form, '=', end - form);
+    if (equals == NULL)
+      return false;
+
+    size_t nameLength = equals - form;
+    int decoded = decodeValue(equals + 1, end - (equals + 1), text, sizeof(text));
+    if (decoded < 0)
+      return false;
+    const char *value = text;
+    size_t valueLength = decoded;
+    uint32_t number;
+
+    if (nameLength == 8 && strncmp(form, "hostname", nameLength) == 0) {
+      if (valueLength >= sizeof(block.hostname) || memchr(value, '\0', valueLength) != NULL)
+        return false;
+      memset(block.hostname, 0, sizeof(block.hostname));
+      memcpy(block.hostname, value, valueLength);
+    } else if (nameLength == 10 && strncmp(form, "brightness", nameLength) == 0) {
+      if (!parseNumber(value, valueLength, number) || number > 255)
+        return false;
+      block.brightness = number;
+    } else if (nameLength == 12 && strncmp(form, "max_power_mW", nameLength) == 0) {
+      if (!parseNumber(value, valueLength, number))
+        return false;
+      block.maxPower_mW = number;
+    } else if (nameLength == 12 && strncmp(form, "effect_order", nameLength) == 0) {
+      // Comma separated effect numbers, empty for the table order.
+      const char *valueEnd = value + valueLength;
+      block.effectCount = 0;
+      while (value < valueEnd) {
+        const char *comma = (const char *)memchr(value, ',', valueEnd - value);
+        if (comma == NULL)
+          comma = valueEnd;
+        if (block.effectCount == SETTINGS_MAX_EFFECTS || !parseNumber(value, comma - value, number) || number > 255)
+          return false;
+        block.effectOrder[block.effectCount++] = number;
+        value = comma < valueEnd ? comma + 1 : valueEnd;
+      }
+      memset(block.effectOrder + block.effectCount, 0, SETTINGS_MAX_EFFECTS - block.effectCount);
+    } else {
+      return false;
+    }
+
+    form = *end ? end + 1 : end;
+  }
+
+  return true;
+}
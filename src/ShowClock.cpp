@@ -0,0 +1,24 @@
+/**
+ * @file ShowClock.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief The show's time in milliseconds, shared by all the controllers.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "ShowClock.h"
+
+ShowClock showClock;
+
+void ShowClock::steer(int32_t error_ms) {
+
+  if (error_ms > SHOW_CLOCK_STEP_ms || error_ms < -SHOW_CLOCK_STEP_ms) {
+    _offset_ms += error_ms;
+    _jumps++;
+  } else {
+    _offset_ms += (error_ms / 2) ? error_ms / 2 : error_ms;   // the last millisecond in one
+  }
+}
@@ -0,0 +1,169 @@
+/**
+ * @file ShowSync.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Keeps the show clock in step with the other controllers over UDP.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note Packets are sent in the controllers' own (little endian) byte order,
+ * only XmasLights controllers speak this protocol.
+ */
+
+#include "ShowClock.h"
+#include "EventLog.h"
+#include "ShowSync.h"
+
+#define SYNC_MAGIC 0x4e595358           // "XSYN"
+#define SYNC_VERSION 1
+
+enum SyncType : uint8_t {
+  SYNC_REQUEST,
+  SYNC_REPLY
+};
+
+struct SyncPacket {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t type;
+  uint16_t reserved;
+  uint32_t request_us;                  // the requester's micros() when it asked, echoed back
+  uint32_t showTime_ms;                 // the replying controller's show clock
+};
+
+static WiFiUDP syncUdp;
+
+/** Order IP addresses as their dotted form reads. */
+static bool lowerAddress(IPAddress a, IPAddress b) {
+  for (uint8_t i = 0; i < 4; i++)
+    if (a[i] != b[i])
+      return a[i] < b[i];
+  return false;
+}
+
+void ShowSync::begin(IPAddress localIP) {
+
+  _localIP = localIP;
+  _reference = localIP;
+  _samples = 0;
+  _bestRtt_ms = UINT32_MAX;
+
+  syncUdp.stop();                       // the previous connection's socket, if any
+  _listening = syncUdp.begin(SYNC_PORT);
+  chooseReference();
+}
+
+void ShowSync::addPeer(IPAddress ip) {
+
+  if (ip == _localIP || ip == IPAddress(0, 0, 0, 0))
+    return;
+
+  for (uint8_t i = 0; i < _peerCount; i++) {
+    if (_peers[i].ip == ip) {
+      _peers[i].seen_ms = millis();
+      return;
+    }
+  }
+
+  if (_peerCount < SYNC_MAX_PEERS) {
+    _peers[_peerCount].ip = ip;
+    _peers[_peerCount].seen_ms = millis();
+    _peerCount++;
+    chooseReference();
+  }
+}
+
+void ShowSync::expirePeers() {
+
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < _peerCount; i++)
+    if ((millis() - _peers[i].seen_ms) < SYNC_PEER_TIMEOUT_ms)
+      _peers[kept++] = _peers[i];
+
+  if (kept != _peerCount) {
+    _peerCount = kept;
+    chooseReference();
+  }
+}
+
+void ShowSync::chooseReference() {
+
+  IPAddress reference = _localIP;
+  for (uint8_t i = 0; i < _peerCount; i++)
+    if (lowerAddress(_peers[i].ip, reference))
+      reference = _peers[i].ip;
+
+  if (!(reference == _reference)) {
+    _reference = reference;
+    _samples = 0;
+    _bestRtt_ms = UINT32_MAX;
+  }
+}
+
+void ShowSync::sendRequest() {
+
+  SyncPacket request = { SYNC_MAGIC, SYNC_VERSION, SYNC_REQUEST, 0, (uint32_t)micros(), showClock.now_ms() };
+  syncUdp.beginPacket(_reference, SYNC_PORT);
+  syncUdp.write((const uint8_t *)&request, sizeof(request));
+  syncUdp.endPacket();
+}
+
+void ShowSync::handlePacket() {
+
+  SyncPacket packet;
+  if (syncUdp.read((uint8_t *)&packet, sizeof(packet)) != (int)sizeof(packet)
+      || packet.magic != SYNC_MAGIC || packet.version != SYNC_VERSION)
+    return;
+
+  IPAddress from = syncUdp.remoteIP();
+
+  if (packet.type == SYNC_REQUEST) {
+    addPeer(from);
+    SyncPacket reply = { SYNC_MAGIC, SYNC_VERSION, SYNC_REPLY, 0, packet.request_us, showClock.now_ms() };
+    syncUdp.beginPacket(from, syncUdp.remotePort());
+    syncUdp.write((const uint8_t *)&reply, sizeof(reply));
+    syncUdp.endPacket();
+    return;
+  }
+
+  if (packet.type != SYNC_REPLY || !(from == _reference))
+    return;
+
+  uint32_t rtt_ms = (micros() - packet.request_us) / 1000;
+  if (rtt_ms > SYNC_MAX_RTT_ms)
+    return;                             // stale, or held up too long to be worth using
+
+  int32_t error_ms = (int32_t)(packet.showTime_ms + rtt_ms / 2 - showClock.now_ms());
+  _lastRtt_ms = rtt_ms;
+  _lastError_ms = error_ms;
+  if (rtt_ms < _bestRtt_ms) {
+    _bestRtt_ms = rtt_ms;
+    _bestError_ms = error_ms;
+  }
+
+  if (++_samples >= SYNC_SAMPLES) {
+    uint32_t jumps = showClock.jumps();
+    showClock.steer(_bestError_ms);
+    if (showClock.jumps() != jumps)
+      eventLog.log(LOG_CLOCK_STEPPED, _bestError_ms);
+    _samples = 0;
+    _bestRtt_ms = UINT32_MAX;
+  }
+}
+
+void ShowSync::poll() {
+
+  if (!_listening)
+    return;
+
+  if (syncUdp.parsePacket() > 0)
+    handlePacket();
+
+  expirePeers();
+
+  if (!isReference() && (millis() - _lastRequest_ms) >= SYNC_INTERVAL_ms) {
+    _lastRequest_ms = millis();
+    sendRequest();
+  }
+}
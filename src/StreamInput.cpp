@@ -0,0 +1,173 @@
+/**
+ * @file StreamInput.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Frames streamed from a sequencer over E1.31 (sACN).
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note Multi-byte E1.31 fields are big endian.
+ */
+
+#include <WiFiNINA.h>
+
+#include "LedOutput.h"
+#include "StreamInput.h"
+
+/** Offsets into the E1.31 data packet. */
+#define E131_PREAMBLE_SIZE 0
+#define E131_ACN_ID 4
+#define E131_ROOT_VECTOR 18
+#define E131_FRAMING_VECTOR 40
+#define E131_SEQUENCE 111
+#define E131_OPTIONS 112
+#define E131_UNIVERSE 113
+#define E131_DMP_VECTOR 117
+#define E131_ADDRESS_TYPE 118
+#define E131_VALUE_COUNT 123
+#define E131_START_CODE 125
+
+#define E131_VECTOR_ROOT_DATA 0x00000004
+#define E131_VECTOR_DATA_PACKET 0x00000002
+#define E131_VECTOR_DMP_SET_PROPERTY 0x02
+#define E131_OPTION_PREVIEW 0x80        // for visualisers, not for the lights
+#define E131_OPTION_TERMINATED 0x40     // the source has stopped sending this universe
+
+static const uint8_t acnPacketId[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+static WiFiUDP e131Udp;
+
+static uint16_t read16(const uint8_t *bytes) {
+  return ((uint16_t)bytes[0] << 8) | bytes[1];
+}
+
+static uint32_t read32(const uint8_t *bytes) {
+  return ((uint32_t)read16(bytes) << 16) | read16(bytes + 2);
+}
+
+void StreamInput::begin() {
+
+#if STREAM_INPUT
+  e131Udp.stop();                       // the previous connection's socket, if any
+  _listening = e131Udp.begin(E131_PORT);
+#endif
+}
+
+bool StreamInput::takeFrame() {
+
+  if (!_frameChanged)
+    return false;
+
+  _frameChanged = false;
+  markFrameDirty();
+  return true;
+}
+
+bool StreamInput::acceptSequence(uint8_t universeIndex, uint8_t sequence) {
+
+  if (_sequenceValid[universeIndex]) {
+    int8_t ahead = (int8_t)(sequence - _lastSequence[universeIndex]);
+    if (ahead <= 0 && ahead > -E131_LATE_WINDOW) {
+      _late++;
+      return false;
+    }
+    if (ahead > 1)
+      _lost += ahead - 1;
+  }
+
+  _lastSequence[universeIndex] = sequence;
+  _sequenceValid[universeIndex] = true;
+  return true;
+}
+
+void StreamInput::readPacket(int size) {
+
+#if STREAM_INPUT
+  uint8_t header[E131_HEADER_SIZE];
+
+  if (size < E131_HEADER_SIZE + 1 || e131Udp.read(header, E131_HEADER_SIZE) != E131_HEADER_SIZE) {
+    _invalid++;
+    return;
+  }
+
+  if (read16(header + E131_PREAMBLE_SIZE) != 0x0010
+      || memcmp(header + E131_ACN_ID, acnPacketId, sizeof(acnPacketId)) != 0
+      || read32(header + E131_ROOT_VECTOR) != E131_VECTOR_ROOT_DATA) {
+    _invalid++;                         // sync and discovery packets end up here too
+    return;
+  }
+
+  if (read32(header + E131_FRAMING_VECTOR) != E131_VECTOR_DATA_PACKET
+      || header[E131_DMP_VECTOR] != E131_VECTOR_DMP_SET_PROPERTY
+      || header[E131_ADDRESS_TYPE] != 0xa1
+      || header[E131_START_CODE] != 0) {
+    _invalid++;
+    return;
+  }
+
+  uint8_t options = header[E131_OPTIONS];
+  if (options & E131_OPTION_PREVIEW)
+    return;
+
+  uint16_t universe = read16(header + E131_UNIVERSE);
+  if (universe < E131_FIRST_UNIVERSE || universe >= E131_FIRST_UNIVERSE + E131_UNIVERSES)
+    return;                             // some other controller's pixels
+  uint8_t universeIndex = universe - E131_FIRST_UNIVERSE;
+
+  if (options & E131_OPTION_TERMINATED) {
+    _active = false;
+    _sequenceValid[universeIndex] = false;
+    return;
+  }
+
+  if (!acceptSequence(universeIndex, header[E131_SEQUENCE]))
+    return;
+
+  // Value count includes the start code.  Read only whole pixels that are ours.
+  int channels = min((int)read16(header + E131_VALUE_COUNT) - 1, size - E131_HEADER_SIZE);
+  int first = universeIndex * E131_PIXELS_PER_UNIVERSE;
+  int pixels = min(channels / 3, min((int)E131_PIXELS_PER_UNIVERSE, (int)NUMBER_OF_LIGHTS - first));
+  if (pixels <= 0) {
+    _invalid++;
+    return;
+  }
+
+  e131Udp.read((uint8_t *)&leds[first], pixels * sizeof(CRGB));
+
+  _packets++;
+  _windowPackets++;
+  _lastPacket_ms = millis();
+  _active = true;
+  _frameChanged = true;
+#else
+  (void)size;
+#endif
+}
+
+void StreamInput::poll() {
+
+  uint32_t now = millis();
+
+  if (now - _windowStart_ms >= 1000) {
+    _packetsPerSecond = _windowPackets;
+    _windowPackets = 0;
+    _windowStart_ms = now;
+  }
+
+  if (!_listening)
+    return;
+
+  for (uint8_t i = 0; i < STREAM_MAX_PACKETS_PER_POLL; i++) {
+    int size = e131Udp.parsePacket();   // also discards whatever was left of the last one
+    if (size <= 0)
+      break;
+    readPacket(size);
+  }
+
+  if (_active && (millis() - _lastPacket_ms) > STREAM_TIMEOUT_ms) {
+    _active = false;
+    for (uint8_t u = 0; u < E131_UNIVERSES; u++)
+      _sequenceValid[u] = false;
+  }
+}
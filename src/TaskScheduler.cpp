@@ -0,0 +1,71 @@
+/**
+ * @file TaskScheduler.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Cooperative background tasks run in the gaps between frames.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "TaskScheduler.h"
+
+TaskScheduler::TaskScheduler(const FrameScheduler &frames) : _frames(frames) {}
+
+bool TaskScheduler::addTask(const char *name, TaskFunction run, uint16_t slice_us, uint16_t interval_ms, ProfileStage stage) {
+
+  if (_taskCount >= TASK_MAX_TASKS)
+    return false;
+
+  Task &task = _tasks[_taskCount++];
+  task.name = name;
+  task.run = run;
+  task.slice_us = slice_us;
+  task.interval_ms = interval_ms;
+  task.stage = stage;
+  task.lastRun_ms = millis();
+  task.stats = TaskStats();
+  return true;
+}
+
+void TaskScheduler::runIdle(uint32_t reserve_us) {
+
+  uint32_t ranThisFrame = 0;            // one bit per task
+  uint32_t dueThisFrame = 0;
+  bool ranAny;
+
+  do {
+    ranAny = false;
+
+    for (uint8_t i = 0; i < _taskCount; i++) {
+      Task &task = _tasks[i];
+      uint32_t waited_ms = millis() - task.lastRun_ms;
+
+      if (task.interval_ms && waited_ms < task.interval_ms)
+        continue;
+      dueThisFrame |= 1UL << i;
+
+      bool starved = waited_ms >= (uint32_t)task.interval_ms + TASK_STARVATION_ms;
+      if (_frames.timeRemaining_us() < reserve_us + task.slice_us && !starved)
+        continue;
+
+      uint32_t started = micros();
+      task.run();
+      uint32_t took_us = micros() - started;
+      frameProfiler.lap(task.stage);
+
+      task.lastRun_ms = millis();
+      task.stats.runs++;
+      if (took_us > task.stats.worst_us)
+        task.stats.worst_us = took_us;
+
+      ranThisFrame |= 1UL << i;
+      ranAny = true;
+    }
+  } while (ranAny && _frames.timeRemaining_us() > reserve_us);
+
+  for (uint8_t i = 0; i < _taskCount; i++)
+    if ((dueThisFrame & ~ranThisFrame) & (1UL << i))
+      _tasks[i].stats.deferred++;
+}
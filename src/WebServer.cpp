@@ -0,0 +1,1051 @@
+/**
+ * @file WebServer.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Non-blocking status web server.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The connection is a small state machine that is advanced once per call to
+ * processAnyWebRequests().  Each call only consumes the bytes the client has
+ * already sent, within a byte and time budget, so a slow or idle client can
+ * never hold up the LED frame loop.
+ *
+ * The status page itself is a fixed shell, built once and cached by browsers
+ * against its ETag.  Its numbers come over /events, a server-sent event
+ * stream, as a message each HTTP_EVENTS_INTERVAL_ms with only the fields that
+ * have changed.  A request for /events is answered on the connection like any
+ * other, then its client moves to one of HTTP_EVENT_CLIENTS stream slots,
+ * leaving the connection free for the next request.
+ */
+
+#include <Arduino.h>
+#include <WiFiNINA.h>
+#include <unistd.h>                     // sbrk()
+
+#include "XmasLights.h"
+#include "BufferWriter.h"
+#include "FrameProfiler.h"
+#include "TaskScheduler.h"
+#include "WifiConnection.h"
+#include "StreamInput.h"
+#include "ShowClock.h"
+#include "ShowSync.h"
+#include "EventLog.h"
+#include "PowerTelemetry.h"
+#include "LedOutput.h"
+#include "Effects.h"
+#include "Settings.h"
+#include "SettingsForm.h"
+#include "WebServer.h"
+
+enum HttpState {
+  HTTP_IDLE,                // waiting for a client
+  HTTP_READING_REQUEST,     // consuming the request header, then any body
+  HTTP_SENDING_RESPONSE,    // writing the response out in chunks
+  HTTP_CLOSING              // response sent, close on the next poll
+};
+
+struct HttpConnection {
+  WiFiClient client;
+  HttpState state = HTTP_IDLE;
+  uint32_t startedAt_ms = 0;
+
+  // receive buffer - holds at most one partially received header line
+  char rx[HTTP_RX_BUFFER_SIZE];
+  uint16_t rxLength = 0;
+  bool discardingLine = false;      // current line overflowed rx and is being skipped
+  bool haveRequestLine = false;
+  bool requestTooLong = false;
+  bool notModified = false;         // If-None-Match named the status page's current tag
+  bool headerComplete = false;
+  bool bodyTooLong = false;
+
+  char method[HTTP_MAX_METHOD];
+  char path[HTTP_MAX_PATH];
+  char host[HTTP_MAX_HOST];         // the Host header
+  char origin[HTTP_MAX_HOST];       // the host named in the Origin header, empty without one
+
+  char body[HTTP_MAX_BODY + 1];     // NUL terminated once it's all in
+  uint16_t contentLength = 0;
+  uint16_t bodyLength = 0;
+
+  const char *responseData = NULL;
+  uint16_t responseLength = 0;
+  uint16_t responseSent = 0;
+  int8_t eventClient = -1;          // slot the client moves to once the response is sent
+
+  bool (*renderPart)(uint8_t part) = NULL;   // renders the rest of a response built as it's sent
+  uint8_t nextPart = 0;
+};
+
+/** The pages we can serve, matched on method and path (ignoring any query). */
+struct HttpRoute {
+  const char *method;
+  const char *path;
+  void (*render)();
+};
+
+/** Fields of the status page, pushed to it over /events as they change. */
+enum StatusField {
+  STATUS_POWER,
+  STATUS_POWER_MIN,
+  STATUS_POWER_MAX,
+  STATUS_POWER_LIMITED,
+  STATUS_POWER_DEMAND,
+  STATUS_FPS,
+  STATUS_EFFECT,
+  STATUS_OVERRUNS,
+  STATUS_WORST_FRAME,
+  NBR_OF_STATUS_FIELDS
+};
+
+/** A constant piece of the status page followed by the element showing a field. */
+struct StatusPagePart {
+  const char *text;
+  const char *id;               // the element's id, and the field's name in the events
+};
+
+static const char statusPageHeader[] PROGMEM =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/html\r\n"
+  "Cache-Control: max-age=%u\r\n"
+  "ETag: %s\r\n"
+  "Connection: close\r\n"       // the connection will be closed after completion of the response
+  "Content-Length: %u\r\n"
+  "\r\n";
+
+static const char notModifiedHeader[] PROGMEM =
+  "HTTP/1.1 304 Not Modified\r\n"
+  "Cache-Control: max-age=%u\r\n"
+  "ETag: %s\r\n"
+  "Connection: close\r\n"
+  "\r\n";
+
+/** The status page body up to the host name, then one entry per StatusField plus the closing text. */
+static const char statusPageTop[] PROGMEM =
+  "<!DOCTYPE HTML>\r\n"
+  "<html>\r\n"
+  "<h1>";
+
+static const StatusPagePart statusPageParts[NBR_OF_STATUS_FIELDS + 1] PROGMEM = {
+  { "</h1>\r\n"
+    "<h2>LED Status</h2>\r\n"
+    "Power Draw = ", "power" },
+  { " mW\r\n<br />\r\nPower Range = ", "power_min" },
+  { " - ", "power_max" },
+  { " mW\r\n<br />\r\nPower Limited = ", "limited" },
+  { " % of frames\r\n<br />\r\nPeak Demand = ", "demand" },
+  { " % of budget\r\n<br />\r\nFPS = ", "fps" },
+  { "\r\n<br />\r\nEffect Number = ", "effect" },
+  { "\r\n<br />\r\nFrame Overruns = ", "overruns" },
+  { "\r\n<br />\r\nWorst Frame = ", "worst_us" },
+  { " us\r\n"
+    "<script>\r\n"
+    "new EventSource('/events').onmessage = function (e) {\r\n"
+    "  var fields = JSON.parse(e.data);\r\n"
+    "  for (var id in fields) document.getElementById(id).textContent = fields[id];\r\n"
+    "};\r\n"
+    "</script>\r\n"
+    "</html>\r\n", NULL }
+};
+
+static const char eventStreamHeader[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-store\r\n"
+  "\r\n"
+  "retry: 5000\n"                 // how long the browser waits to reconnect
+  "\n";
+
+enum EventClientState {
+  EVENTS_FREE,
+  EVENTS_OPENING,           // taken, the stream header is still going out on the request's connection
+  EVENTS_OPEN               // streaming
+};
+
+/** A browser following /events.  Each is sent the fields that changed since its last message. */
+struct EventClient {
+  WiFiClient client;
+  EventClientState state = EVENTS_FREE;
+  bool sentAll = false;         // the first message carries every field
+  uint32_t sent[NBR_OF_STATUS_FIELDS];
+  uint32_t nextPush_ms = 0;
+  uint32_t lastSent_ms = 0;
+};
+
+static WiFiServer server(HTTP_PORT);
+static HttpConnection connection;
+static EventClient eventClients[HTTP_EVENT_CLIENTS];
+static char response[HTTP_ERROR_RESPONSE_SIZE];
+static char eventMessage[HTTP_EVENT_MESSAGE_SIZE];
+
+/** The complete status response, built once by buildStatusPage(), and its entity tag. */
+static char statusPage[HTTP_STATUS_PAGE_SIZE];
+static const char *statusPageStart = statusPage;
+static uint16_t statusPageLength = 0;
+static char statusPageTag[11];
+
+/** FNV-1a, enough to tell one build of the page from another. */
+static uint32_t hashOf(const char *data, size_t length) {
+  uint32_t hash = 2166136261u;
+  while (length--) {
+    hash ^= (uint8_t)*data++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/** Lay out the status page, with empty elements for the fields the events fill in.
+ *
+ * The page only changes with the host name, so browsers keep it for
+ * HTTP_STATUS_MAX_AGE_s and after that check it against its ETag.
+ */
+static void buildStatusPage() {
+
+  char *body = statusPage + HTTP_STATUS_HEADER_ROOM;
+  BufferWriter out(body, sizeof(statusPage) - HTTP_STATUS_HEADER_ROOM);
+
+  out.append(statusPageTop).append(settings.current().hostname);
+  for (unsigned int i = 0; i <= NBR_OF_STATUS_FIELDS; i++) {
+    const StatusPagePart &part = statusPageParts[i];
+    out.append(part.text);
+    if (part.id != NULL)
+      out.append("<span id=\"").append(part.id).append("\"></span>");
+  }
+
+  snprintf(statusPageTag, sizeof(statusPageTag), "\"%08lx\"", (unsigned long)hashOf(body, out.length()));
+
+  char header[HTTP_STATUS_HEADER_ROOM];
+  int headerLength = snprintf_P(header, sizeof(header), statusPageHeader,
+                                HTTP_STATUS_MAX_AGE_s, statusPageTag, out.length());
+  headerLength = min(headerLength, (int)sizeof(header) - 1);
+  memcpy(body - headerLength, header, headerLength);
+
+  statusPageStart = body - headerLength;
+  statusPageLength = headerLength + out.length();
+}
+
+/** Queue the status page, or just its headers if the browser's copy is current. */
+static void renderStatusPage() {
+
+  if (connection.notModified) {
+    int len = snprintf_P(response, sizeof(response), notModifiedHeader, HTTP_STATUS_MAX_AGE_s, statusPageTag);
+    connection.responseData = response;
+    connection.responseLength = min(len, (int)sizeof(response) - 1);
+    connection.responseSent = 0;
+    return;
+  }
+
+  connection.responseData = statusPageStart;
+  connection.responseLength = statusPageLength;
+  connection.responseSent = 0;
+}
+
+static uint32_t statusFieldValue(StatusField field) {
+
+  switch (field) {
+    case STATUS_POWER:          return powerTelemetry.average_mW();
+    case STATUS_POWER_MIN:      return powerTelemetry.min_mW();
+    case STATUS_POWER_MAX:      return powerTelemetry.max_mW();
+    case STATUS_POWER_LIMITED:  return powerTelemetry.limitedPercent();
+    case STATUS_POWER_DEMAND:   return powerTelemetry.peakDemandPercent();
+    case STATUS_FPS:            return outputFPS();
+    case STATUS_EFFECT:         return currentEffectNbr;
+    case STATUS_OVERRUNS:       return frameScheduler.overruns();
+    case STATUS_WORST_FRAME:    return frameScheduler.worstFrame_us();
+    default:                    return 0;
+  }
+}
+
+/** Responses built on request (/metrics, /status.json, /settings) are rendered
+ * a part at a time as the last part goes out, so the buffer only has to hold
+ * the largest part rather than the whole response.  Their length isn't known
+ * up front, so they have no Content-Length and end as the connection closes.
+ */
+static char dataPart[HTTP_DATA_SIZE];
+static BufferWriter dataBody(dataPart, sizeof(dataPart));
+
+/** Bytes between the top of the heap and the stack. */
+static uint32_t freeMemory() {
+  char top;
+  return &top - (char *)sbrk(0);
+}
+
+/** Queue the part of a data response just rendered into dataBody. */
+static void queueDataPart() {
+  connection.responseData = dataBody.data();
+  connection.responseLength = dataBody.length();
+  connection.responseSent = 0;
+}
+
+/** Start a data response, the header and its first part.  renderPart(n)
+ * renders part n into dataBody, returning false once there are no more.
+ */
+static void queueDataResponse(const char *contentType, bool (*renderPart)(uint8_t part)) {
+
+  dataBody.clear();
+  dataBody.append("HTTP/1.1 200 OK\r\n"
+                  "Content-Type: ").append(contentType).append("\r\n"
+                  "Cache-Control: no-store\r\n"
+                  "Connection: close\r\n"
+                  "\r\n");
+  renderPart(0);
+
+  connection.renderPart = renderPart;
+  connection.nextPart = 1;
+  queueDataPart();
+}
+
+/** A Prometheus gauge or counter with no labels. */
+static void appendMetric(const char *name, const char *type, uint32_t value) {
+  dataBody.append("# TYPE ").append(name).append(' ').append(type).append('\n')
+          .append(name).append(' ').append(value).append('\n');
+}
+
+/** One of the background task statistics, labelled by task. */
+static void appendTaskMetric(const char *name, const char *type, uint32_t TaskStats::*field) {
+  dataBody.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+  for (uint8_t t = 0; t < taskScheduler.taskCount(); t++)
+    dataBody.append(name).append("{task=\"").append(taskScheduler.taskName(t)).append("\"} ")
+            .append(taskScheduler.taskStats(t).*field).append('\n');
+}
+
+/** The /metrics parts, each a whole number of metric families. */
+static void renderScalarMetrics() {
+  appendMetric("xmas_uptime_seconds", "counter", millis() / 1000);
+  appendMetric("xmas_effect", "gauge", currentEffectNbr);
+  appendMetric("xmas_fps", "gauge", outputFPS());
+  appendMetric("xmas_power_mW", "gauge", powerTelemetry.average_mW());
+  appendMetric("xmas_power_min_mW", "gauge", powerTelemetry.min_mW());
+  appendMetric("xmas_power_max_mW", "gauge", powerTelemetry.max_mW());
+  appendMetric("xmas_power_limited_percent", "gauge", powerTelemetry.limitedPercent());
+  appendMetric("xmas_power_demand_percent", "gauge", powerTelemetry.peakDemandPercent());
+  appendMetric("xmas_brightness", "gauge", powerTelemetry.brightness());
+  dataBody.append("# TYPE xmas_rssi_dBm gauge\nxmas_rssi_dBm ").append((int32_t)WiFi.RSSI()).append('\n');
+  appendMetric("xmas_frames_shown_total", "counter", framesShown());
+  appendMetric("xmas_frames_skipped_total", "counter", framesSkipped());
+  appendMetric("xmas_frames_dropped_total", "counter", framesDropped());
+  appendMetric("xmas_frame_overruns_total", "counter", frameScheduler.overruns());
+  appendMetric("xmas_worst_frame_us", "gauge", frameScheduler.worstFrame_us());
+  appendMetric("xmas_last_frame_us", "gauge", frameScheduler.lastFrame_us());
+  appendMetric("xmas_free_memory_bytes", "gauge", freeMemory());
+  appendMetric("xmas_http_event_clients", "gauge", eventClientCount());
+  appendMetric("xmas_first_frame_ms", "gauge", firstFrame_ms());
+}
+
+static void renderNetworkMetrics() {
+  appendMetric("xmas_wifi_connected_ms", "gauge", wifiConnection.firstConnected_ms());
+  appendMetric("xmas_wifi_reconnects_total", "counter", wifiConnection.reconnects());
+  appendMetric("xmas_wifi_failed_attempts_total", "counter", wifiConnection.failedAttempts());
+  dataBody.append("# TYPE xmas_show_clock_offset_ms gauge\nxmas_show_clock_offset_ms ").append(showClock.offset_ms()).append('\n');
+  appendMetric("xmas_show_clock_jumps_total", "counter", showClock.jumps());
+  appendMetric("xmas_sync_peers", "gauge", showSync.peerCount());
+  appendMetric("xmas_sync_reference", "gauge", showSync.isReference());
+  appendMetric("xmas_sync_rtt_ms", "gauge", showSync.lastRtt_ms());
+  dataBody.append("# TYPE xmas_sync_error_ms gauge\nxmas_sync_error_ms ").append(showSync.lastError_ms()).append('\n');
+  appendMetric("xmas_stream_active", "gauge", streamInput.active());
+  appendMetric("xmas_stream_packets_per_second", "gauge", streamInput.packetsPerSecond());
+  appendMetric("xmas_stream_packets_total", "counter", streamInput.packets());
+  appendMetric("xmas_stream_late_packets_total", "counter", streamInput.latePackets());
+  appendMetric("xmas_stream_lost_packets_total", "counter", streamInput.lostPackets());
+  appendMetric("xmas_stream_invalid_packets_total", "counter", streamInput.invalidPackets());
+
+  appendMetric("xmas_log_records_total", "counter", eventLog.logged());
+  appendMetric("xmas_log_suppressed_total", "counter", eventLog.suppressed());
+  appendMetric("xmas_log_dropped_total", "counter", eventLog.dropped());
+}
+
+static void renderStageMetrics() {
+
+  static const char *const statNames[] = { "min", "avg", "max" };
+
+  dataBody.append("# HELP xmas_stage_us Time per frame in each loop stage, over the last window.\n"
+                  "# TYPE xmas_stage_us gauge\n");
+  for (uint8_t i = 0; i < NBR_OF_PROFILE_STAGES; i++) {
+    ProfileStage stage = (ProfileStage)i;
+    const ProfileStats &stats = frameProfiler.stats(stage);
+    const uint32_t values[] = { stats.min_us, stats.average_us, stats.max_us };
+    for (uint8_t v = 0; v < 3; v++)
+      dataBody.append("xmas_stage_us{stage=\"").append(FrameProfiler::stageName(stage))
+              .append("\",stat=\"").append(statNames[v]).append("\"} ").append(values[v]).append('\n');
+  }
+}
+
+static void renderTaskMetrics() {
+  appendTaskMetric("xmas_task_runs_total", "counter", &TaskStats::runs);
+  appendTaskMetric("xmas_task_deferred_total", "counter", &TaskStats::deferred);
+  appendTaskMetric("xmas_task_worst_us", "gauge", &TaskStats::worst_us);
+}
+
+static void renderEffectInfoMetrics() {
+
+  uint8_t nbrOfEffects = min(effectCount(), (uint8_t)PROFILE_MAX_EFFECTS);
+
+  dataBody.append("# TYPE xmas_effect_info gauge\n");
+  for (uint8_t e = 0; e < nbrOfEffects; e++)
+    dataBody.append("xmas_effect_info{effect=\"").append((uint32_t)e)
+            .append("\",name=\"").append(getEffect(e).name).append("\"} 1\n");
+  dataBody.append("# HELP xmas_frame_busy_us Frame time less the idle wait, by effect.\n"
+                  "# TYPE xmas_frame_busy_us histogram\n");
+}
+
+/** One effect's xmas_frame_busy_us histogram, the family's header is sent with the effect info. */
+static void renderEffectHistogram(uint8_t e) {
+
+  uint32_t count = 0;
+  for (uint8_t b = 0; b < PROFILE_HISTOGRAM_BUCKETS; b++) {
+    count += frameProfiler.histogram(e, b);
+    dataBody.append("xmas_frame_busy_us_bucket{effect=\"").append((uint32_t)e).append("\",le=\"");
+    if (b < PROFILE_HISTOGRAM_BUCKETS - 1)
+      dataBody.append(FrameProfiler::bucketLimit_us(b));
+    else
+      dataBody.append("+Inf");
+    dataBody.append("\"} ").append(count).append('\n');
+  }
+  dataBody.append("xmas_frame_busy_us_sum{effect=\"").append((uint32_t)e).append("\"} ")
+          .append(frameProfiler.histogramSum_us(e)).append('\n');
+  dataBody.append("xmas_frame_busy_us_count{effect=\"").append((uint32_t)e).append("\"} ")
+          .append(count).append('\n');
+}
+
+static void (*const metricsParts[])() = {
+  renderScalarMetrics,
+  renderNetworkMetrics,
+  renderStageMetrics,
+  renderTaskMetrics,
+  renderEffectInfoMetrics,
+};
+
+static constexpr uint8_t nbrOfMetricsParts = sizeof(metricsParts) / sizeof(metricsParts[0]);
+
+/** The fixed parts, then one per effect's histogram. */
+static bool renderMetricsPart(uint8_t part) {
+
+  if (part < nbrOfMetricsParts) {
+    metricsParts[part]();
+    return true;
+  }
+
+  uint8_t effect = part - nbrOfMetricsParts;
+  if (effect >= min(effectCount(), (uint8_t)PROFILE_MAX_EFFECTS))
+    return false;
+  renderEffectHistogram(effect);
+  return true;
+}
+
+/** Queue the controller's state, stage timings and per effect frame histograms, in Prometheus text format. */
+static void renderMetrics() {
+  queueDataResponse("text/plain; version=0.0.4", renderMetricsPart);
+}
+
+/** JSON member helpers, each writes its leading comma unless it is the first in its object. */
+static void jsonKey(const char *name, bool first) {
+  if (!first)
+    dataBody.append(',');
+  dataBody.appendJsonString(name).append(':');
+}
+
+static void jsonField(const char *name, uint32_t value, bool first = false) {
+  jsonKey(name, first);
+  dataBody.append(value);
+}
+
+/** The /status.json parts, which together make a single JSON object. */
+static void renderStatusJsonTop() {
+
+  dataBody.append('{');
+  jsonKey("host", true);
+  dataBody.appendJsonString(settings.current().hostname);
+  jsonField("uptime_s", millis() / 1000);
+  jsonKey("rssi_dBm", false);
+  dataBody.append((int32_t)WiFi.RSSI());
+  jsonField("free_memory", freeMemory());
+  jsonField("event_clients", eventClientCount());
+
+  jsonKey("wifi", false);
+  dataBody.append('{');
+  jsonKey("state", true);
+  dataBody.appendJsonString(WifiConnection::stateName(wifiConnection.state()));
+  jsonField("connected_ms", wifiConnection.firstConnected_ms());
+  jsonField("reconnects", wifiConnection.reconnects());
+  jsonField("failed_attempts", wifiConnection.failedAttempts());
+  dataBody.append('}');
+
+  jsonKey("sync", false);
+  dataBody.append('{');
+  jsonField("show_clock_ms", showClock.now_ms(), true);
+  jsonKey("offset_ms", false);
+  dataBody.append(showClock.offset_ms());
+  jsonField("jumps", showClock.jumps());
+  jsonField("peers", showSync.peerCount());
+  jsonKey("reference", false);
+  dataBody.append(showSync.isReference() ? "true" : "false");
+  jsonField("rtt_ms", showSync.lastRtt_ms());
+  jsonKey("error_ms", false);
+  dataBody.append(showSync.lastError_ms());
+  dataBody.append('}');
+}
+
+static void renderStatusJsonShow() {
+
+  jsonKey("stream", false);
+  dataBody.append('{');
+  jsonField("active", streamInput.active(), true);
+  jsonField("packets_per_second", streamInput.packetsPerSecond());
+  jsonField("packets", streamInput.packets());
+  jsonField("late", streamInput.latePackets());
+  jsonField("lost", streamInput.lostPackets());
+  jsonField("invalid", streamInput.invalidPackets());
+  dataBody.append('}');
+
+  jsonKey("log", false);
+  dataBody.append('{');
+  jsonField("records", eventLog.logged(), true);
+  jsonField("suppressed", eventLog.suppressed());
+  jsonField("dropped", eventLog.dropped());
+  dataBody.append('}');
+
+  jsonKey("effect", false);
+  dataBody.append('{');
+  jsonField("number", currentEffectNbr, true);
+  jsonKey("name", false);
+  dataBody.appendJsonString(currentEffect().name);
+  dataBody.append('}');
+
+  jsonKey("power", false);
+  dataBody.append('{');
+  jsonField("average_mW", powerTelemetry.average_mW(), true);
+  jsonField("min_mW", powerTelemetry.min_mW());
+  jsonField("max_mW", powerTelemetry.max_mW());
+  jsonField("limited_percent", powerTelemetry.limitedPercent());
+  jsonField("demand_percent", powerTelemetry.peakDemandPercent());
+  jsonField("brightness", powerTelemetry.brightness());
+  dataBody.append('}');
+}
+
+static void renderStatusJsonTimings() {
+
+  jsonKey("frames", false);
+  dataBody.append('{');
+  jsonField("fps", outputFPS(), true);
+  jsonField("first_ms", firstFrame_ms());
+  jsonField("shown", framesShown());
+  jsonField("skipped", framesSkipped());
+  jsonField("dropped", framesDropped());
+  jsonField("overruns", frameScheduler.overruns());
+  jsonField("worst_us", frameScheduler.worstFrame_us());
+  jsonField("last_us", frameScheduler.lastFrame_us());
+  dataBody.append('}');
+
+  jsonKey("stages_us", false);
+  dataBody.append('{');
+  for (uint8_t i = 0; i < NBR_OF_PROFILE_STAGES; i++) {
+    ProfileStage stage = (ProfileStage)i;
+    const ProfileStats &stats = frameProfiler.stats(stage);
+    jsonKey(FrameProfiler::stageName(stage), i == 0);
+    dataBody.append('{');
+    jsonField("min", stats.min_us, true);
+    jsonField("avg", stats.average_us);
+    jsonField("max", stats.max_us);
+    dataBody.append('}');
+  }
+  dataBody.append("}}");
+}
+
+static void (*const statusJsonParts[])() = {
+  renderStatusJsonTop,
+  renderStatusJsonShow,
+  renderStatusJsonTimings,
+};
+
+static bool renderStatusJsonPart(uint8_t part) {
+  if (part >= sizeof(statusJsonParts) / sizeof(statusJsonParts[0]))
+    return false;
+  statusJsonParts[part]();
+  return true;
+}
+
+/** Queue the controller's state as a single JSON object, for collectors. */
+static void renderStatusJson() {
+  queueDataResponse("application/json", renderStatusJsonPart);
+}
+
+/** Render a bodyless error response into the response buffer. */
+static void renderError(const char *status) {
+
+  int len = snprintf(response, sizeof(response),
+    "HTTP/1.1 %s\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n",
+    status);
+
+  connection.responseData = response;
+  connection.responseLength = min(len, (int)sizeof(response) - 1);
+  connection.responseSent = 0;
+}
+
+/** The settings as a JSON object, all in one part. */
+static bool renderSettingsJsonPart(uint8_t part) {
+
+  if (part > 0)
+    return false;
+
+  const SettingsBlock &current = settings.current();
+
+  dataBody.append('{');
+  jsonKey("hostname", true);
+  dataBody.appendJsonString(current.hostname);
+  jsonField("brightness", current.brightness);
+  jsonField("max_power_mW", current.maxPower_mW);
+  jsonKey("effect_order", false);
+  dataBody.append('[');
+  for (uint8_t i = 0; i < current.effectCount; i++) {
+    if (i > 0)
+      dataBody.append(',');
+    dataBody.append((uint32_t)current.effectOrder[i]);
+  }
+  dataBody.append(']');
+  jsonField("saves", settings.sequence());
+  dataBody.append('}');
+  return true;
+}
+
+/** Queue the settings, for GET /settings and as the answer to a change. */
+static void renderSettingsJson() {
+  queueDataResponse("application/json", renderSettingsJsonPart);
+}
+
+/** Change the settings given in the form body, see SettingsForm.h
+ *
+ * Only a body is looked at, so a link or an image elsewhere can't change them,
+ * and a request a browser made for another site's page, naming it in the
+ * Origin header, is refused.  Settings that haven't changed aren't written
+ * again, and a change sooner than HTTP_SETTINGS_SAVE_INTERVAL_ms after the
+ * last is turned away, every save wears the flash.
+ */
+static void updateSettings() {
+
+  static uint32_t lastSave_ms;
+  static bool saved = false;
+
+  SettingsBlock block = settings.current();
+
+  if (connection.origin[0] != '\0' && strcasecmp(connection.origin, connection.host) != 0) {
+    renderError("403 Forbidden");
+    return;
+  }
+  if (connection.bodyLength == 0 || !parseSettingsForm(connection.body, block) || !Settings::isValid(block)) {
+    renderError("400 Bad Request");
+    return;
+  }
+  if (memcmp(&block, &settings.current(), sizeof(block)) == 0) {
+    renderSettingsJson();
+    return;
+  }
+  if (saved && millis() - lastSave_ms < HTTP_SETTINGS_SAVE_INTERVAL_ms) {
+    renderError("429 Too Many Requests");
+    return;
+  }
+  if (!settings.save(block)) {
+    renderError("500 Internal Server Error");
+    return;
+  }
+  lastSave_ms = millis();
+  saved = true;
+
+  applySettings();
+  buildStatusPage();                    // the host name is in the page, and in its ETag
+  renderSettingsJson();
+}
+
+/** Take an event client slot for the request's client and queue the stream's header. */
+static void renderEvents() {
+
+  for (int8_t i = 0; i < HTTP_EVENT_CLIENTS; i++) {
+    if (eventClients[i].state != EVENTS_FREE)
+      continue;
+    eventClients[i].state = EVENTS_OPENING;
+    connection.eventClient = i;
+    connection.responseData = eventStreamHeader;
+    connection.responseLength = sizeof(eventStreamHeader) - 1;
+    connection.responseSent = 0;
+    return;
+  }
+
+  renderError("503 Service Unavailable");
+}
+
+static void closeEventClient(EventClient &eventClient) {
+  eventClient.client.stop();
+  eventClient.state = EVENTS_FREE;
+}
+
+/** Send each open event client the fields that have changed since its last message.
+ *
+ * Messages are small enough to go in one write; a client that can't take one
+ * whole is dropped rather than sent half of it, and its browser reconnects.
+ */
+static void serviceEventClients(uint32_t pollStart_us) {
+
+  uint32_t values[NBR_OF_STATUS_FIELDS];
+  bool haveValues = false;
+
+  for (EventClient &eventClient : eventClients) {
+    if (eventClient.state != EVENTS_OPEN)
+      continue;
+    if ((micros() - pollStart_us) >= HTTP_POLL_BUDGET_us)
+      return;                             // the rest on a later poll
+
+    uint32_t now = millis();
+    if ((int32_t)(now - eventClient.nextPush_ms) < 0)
+      continue;
+    eventClient.nextPush_ms = now + HTTP_EVENTS_INTERVAL_ms;
+
+    if (!eventClient.client.connected()) {
+      closeEventClient(eventClient);
+      continue;
+    }
+
+    if (!haveValues) {
+      for (uint8_t f = 0; f < NBR_OF_STATUS_FIELDS; f++)
+        values[f] = statusFieldValue((StatusField)f);
+      haveValues = true;
+    }
+
+    BufferWriter out(eventMessage, sizeof(eventMessage));
+    out.append("data: {");
+    bool changed = false;
+    for (uint8_t f = 0; f < NBR_OF_STATUS_FIELDS; f++) {
+      if (eventClient.sentAll && values[f] == eventClient.sent[f])
+        continue;
+      if (changed)
+        out.append(',');
+      out.appendJsonString(statusPageParts[f].id).append(':').append(values[f]);
+      changed = true;
+    }
+    out.append("}\n\n");
+
+    if (!changed) {
+      if (now - eventClient.lastSent_ms < HTTP_EVENTS_KEEPALIVE_ms)
+        continue;
+      out.clear();
+      out.append(":\n\n");                // a comment, to find out if the client has gone
+    }
+
+    if (eventClient.client.write((const uint8_t *)eventMessage, out.length()) != out.length()) {
+      closeEventClient(eventClient);
+      continue;
+    }
+
+    memcpy(eventClient.sent, values, sizeof(values));
+    eventClient.sentAll = true;
+    eventClient.lastSent_ms = now;
+  }
+}
+
+uint8_t eventClientCount() {
+  uint8_t count = 0;
+  for (const EventClient &eventClient : eventClients)
+    if (eventClient.state != EVENTS_FREE)
+      count++;
+  return count;
+}
+
+static const HttpRoute routes[] = {
+  { "GET", "/", renderStatusPage },
+  { "GET", "/metrics", renderMetrics },
+  { "GET", "/status.json", renderStatusJson },
+  { "GET", "/events", renderEvents },
+  { "GET", "/settings", renderSettingsJson },
+  { "POST", "/settings", updateSettings },
+};
+
+/** Pick the response for the parsed request and render it. */
+static void routeRequest() {
+
+  if (!connection.haveRequestLine || connection.requestTooLong) {
+    renderError(connection.requestTooLong ? "414 URI Too Long" : "400 Bad Request");
+    return;
+  }
+  if (connection.bodyTooLong) {
+    renderError("413 Payload Too Large");
+    return;
+  }
+  connection.body[connection.bodyLength] = '\0';
+
+  size_t pathLength = strcspn(connection.path, "?");
+  bool pathMatched = false;
+
+  for (const HttpRoute &route : routes) {
+    if (strlen(route.path) != pathLength || strncmp(route.path, connection.path, pathLength) != 0)
+      continue;
+    pathMatched = true;
+    if (strcmp(route.method, connection.method) == 0) {
+      route.render();
+      return;
+    }
+  }
+
+  renderError(pathMatched ? "405 Method Not Allowed" : "404 Not Found");
+}
+
+/** Split "METHOD /path HTTP/1.1" into the connection's method and path. */
+static void parseRequestLine(char *line) {
+
+  connection.haveRequestLine = true;
+
+  char *target = strchr(line, ' ');
+  if (target == NULL)
+    return;
+  *target++ = '\0';
+
+  char *version = strchr(target, ' ');
+  if (version != NULL)
+    *version = '\0';
+
+  if (strlen(line) >= sizeof(connection.method) || strlen(target) >= sizeof(connection.path)) {
+    connection.requestTooLong = true;
+    return;
+  }
+
+  strcpy(connection.method, line);
+  strcpy(connection.path, target);
+}
+
+/** Copy a header's value, cut short to fit, skipping the space ahead of it. */
+static void copyHeaderValue(char *into, size_t size, const char *value) {
+
+  value += strspn(value, " \t");
+  size_t length = min(strlen(value), size - 1);
+  memcpy(into, value, length);
+  into[length] = '\0';
+}
+
+/** Work through the complete lines in the receive buffer.
+ *
+ * The first line is the request line.  Of the headers that follow only those
+ * we act on are looked at, and an empty line (the \r\n\r\n at the end of the
+ * header) ends it.  Any partial line left over is moved to the front of the
+ * buffer, after the header that's the start of the body.
+ *
+ * @returns true once the end of the request header has been found.
+ */
+static bool scanHeader() {
+
+  char *lineStart = connection.rx;
+  char *end = connection.rx + connection.rxLength;
+  bool complete = false;
+
+  while (!complete) {
+    char *newline = (char *)memchr(lineStart, '\n', end - lineStart);
+    if (newline == NULL)
+      break;
+
+    char *lineEnd = newline;
+    if (lineEnd > lineStart && lineEnd[-1] == '\r')
+      lineEnd--;
+    *lineEnd = '\0';
+
+    if (connection.discardingLine) {
+      connection.discardingLine = false;      // tail of an overlong line, nothing to look at
+      if (!connection.haveRequestLine) {
+        connection.haveRequestLine = true;
+        connection.requestTooLong = true;
+      }
+    } else if (lineEnd == lineStart) {
+      complete = connection.haveRequestLine;  // ignore blank lines ahead of the request line
+    } else if (!connection.haveRequestLine) {
+      parseRequestLine(lineStart);
+    } else if (strncasecmp(lineStart, "If-None-Match:", 14) == 0) {
+      connection.notModified = strstr(lineStart + 14, statusPageTag) != NULL;
+    } else if (strncasecmp(lineStart, "Content-Length:", 15) == 0) {
+      unsigned long length = strtoul(lineStart + 15, NULL, 10);
+      connection.bodyTooLong = length > HTTP_MAX_BODY;
+      connection.contentLength = connection.bodyTooLong ? 0 : length;
+    } else if (strncasecmp(lineStart, "Host:", 5) == 0) {
+      copyHeaderValue(connection.host, sizeof(connection.host), lineStart + 5);
+    } else if (strncasecmp(lineStart, "Origin:", 7) == 0) {
+      const char *scheme = strstr(lineStart + 7, "://");
+      copyHeaderValue(connection.origin, sizeof(connection.origin), scheme != NULL ? scheme + 3 : lineStart + 7);
+    }
+
+    lineStart = newline + 1;
+  }
+
+  connection.rxLength = end - lineStart;
+  if (connection.rxLength == sizeof(connection.rx)) {
+    // A single line filled the whole buffer - drop it and skip to its end.
+    connection.discardingLine = true;
+    connection.rxLength = 0;
+  } else if (lineStart != connection.rx) {
+    memmove(connection.rx, lineStart, connection.rxLength);
+  }
+
+  return complete;
+}
+
+static bool requestComplete() {
+  return connection.headerComplete && connection.bodyLength == connection.contentLength;
+}
+
+/** Consume whatever part of the request has arrived, within the poll budget.
+ *
+ * Data is pulled from the WiFi module a buffer at a time rather than a byte at
+ * a time, every read is an SPI transaction with the NINA module.  The header
+ * goes through the receive buffer, the Content-Length bytes after it go
+ * straight into the body.
+ *
+ * @returns true once the header and the body have all been read.
+ */
+static bool readRequest(uint32_t pollStart_us) {
+
+  unsigned int bytesRead = 0;
+
+  while (!requestComplete() && bytesRead < HTTP_POLL_BYTE_BUDGET && (micros() - pollStart_us) < HTTP_POLL_BUDGET_us) {
+    int available = connection.client.available();
+    if (available <= 0)
+      break;
+
+    char *into = connection.rx + connection.rxLength;
+    size_t room = sizeof(connection.rx) - connection.rxLength;
+    if (connection.headerComplete) {
+      into = connection.body + connection.bodyLength;
+      room = connection.contentLength - connection.bodyLength;
+    }
+    size_t wanted = min(min((size_t)available, room), (size_t)(HTTP_POLL_BYTE_BUDGET - bytesRead));
+    int n = connection.client.read((uint8_t *)into, wanted);
+    if (n <= 0)
+      break;
+
+    bytesRead += n;
+
+    if (connection.headerComplete) {
+      connection.bodyLength += n;
+    } else {
+      connection.rxLength += n;
+      if (scanHeader()) {
+        // what came in behind the header is the start of the body
+        connection.headerComplete = true;
+        connection.bodyLength = min(connection.rxLength, connection.contentLength);
+        memcpy(connection.body, connection.rx, connection.bodyLength);
+      }
+    }
+  }
+
+  return requestComplete();
+}
+
+/** Write as much of the response as the poll budget allows.
+ *
+ * Each write is at most HTTP_WRITE_CHUNK, and is picked up where it left off
+ * when the module accepts less than we offered.  A data response's next part
+ * is only rendered once the last has all gone.
+ *
+ * @returns true once the whole response has been handed to the client.
+ */
+static bool sendResponse(uint32_t pollStart_us) {
+
+  while ((micros() - pollStart_us) < HTTP_POLL_BUDGET_us) {
+    if (connection.responseSent >= connection.responseLength) {
+      if (connection.renderPart == NULL)
+        break;
+      dataBody.clear();
+      if (!connection.renderPart(connection.nextPart++)) {
+        connection.renderPart = NULL;
+        break;
+      }
+      queueDataPart();
+      continue;
+    }
+
+    size_t chunk = min(connection.responseLength - connection.responseSent, HTTP_WRITE_CHUNK);
+    size_t written = connection.client.write((const uint8_t *)connection.responseData + connection.responseSent, chunk);
+    if (written == 0)
+      break;                      // socket is full, try again next poll
+    connection.responseSent += written;
+  }
+
+  return connection.responseSent >= connection.responseLength && connection.renderPart == NULL;
+}
+
+void beginWebServer() {
+  buildStatusPage();
+  server.begin();
+}
+
+void processAnyWebRequests() {
+
+  uint32_t pollStart_us = micros();
+
+  serviceEventClients(pollStart_us);
+
+  if (connection.state != HTTP_IDLE) {
+    // Drop clients that have gone away or are taking too long.
+    if ((millis() - connection.startedAt_ms) > HTTP_CLIENT_TIMEOUT_ms
+        || (connection.state != HTTP_CLOSING && !connection.client.connected()))
+      connection.state = HTTP_CLOSING;
+  }
+
+  switch (connection.state) {
+    case HTTP_IDLE:
+      connection.client = server.available();
+      if (!connection.client)
+        return;
+      connection.state = HTTP_READING_REQUEST;
+      connection.startedAt_ms = millis();
+      connection.rxLength = 0;
+      connection.discardingLine = false;
+      connection.haveRequestLine = false;
+      connection.requestTooLong = false;
+      connection.notModified = false;
+      connection.headerComplete = false;
+      connection.bodyTooLong = false;
+      connection.host[0] = '\0';
+      connection.origin[0] = '\0';
+      connection.contentLength = 0;
+      connection.bodyLength = 0;
+      connection.eventClient = -1;
+      connection.renderPart = NULL;
+      connection.method[0] = '\0';
+      connection.path[0] = '\0';
+      // fall through - the request has usually arrived already
+
+    case HTTP_READING_REQUEST:
+      if (!readRequest(pollStart_us))
+        break;
+      routeRequest();
+      connection.state = HTTP_SENDING_RESPONSE;
+      // fall through
+
+    case HTTP_SENDING_RESPONSE:
+      if (!sendResponse(pollStart_us))
+        break;
+      if (connection.eventClient >= 0) {
+        // An event stream stays open, in its slot, and the connection is free for the next request.
+        EventClient &eventClient = eventClients[connection.eventClient];
+        eventClient.client = connection.client;
+        eventClient.state = EVENTS_OPEN;
+        eventClient.sentAll = false;
+        eventClient.nextPush_ms = millis();
+        eventClient.lastSent_ms = millis();
+        connection.eventClient = -1;
+        connection.state = HTTP_IDLE;
+        break;
+      }
+      // Closing is left to the next poll, which gives the web browser time to receive the data.
+      connection.state = HTTP_CLOSING;
+      break;
+
+    case HTTP_CLOSING:
+      if (connection.eventClient >= 0) {
+        eventClients[connection.eventClient].state = EVENTS_FREE;   // went before the stream started
+        connection.eventClient = -1;
+      }
+      connection.client.stop();
+      connection.state = HTTP_IDLE;
+      break;
+  }
+}
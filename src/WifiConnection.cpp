@@ -0,0 +1,96 @@
+/**
+ * @file WifiConnection.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Wi-Fi association and reconnection without blocking the lights.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <WiFiNINA.h>
+
+#include "XmasLights.h"
+#include "EventLog.h"
+#include "WifiConnection.h"
+
+static const char *const stateNames[] = { "waiting", "connecting", "connected" };
+
+WifiConnection::WifiConnection(ConnectedCallback onConnected) : _onConnected(onConnected) {}
+
+const char *WifiConnection::stateName(WifiState state) {
+  return stateNames[state];
+}
+
+void WifiConnection::begin(const char *ssid, const char *password, const char *hostname) {
+
+  _ssid = ssid;
+  _password = password;
+  _hostname = hostname;
+  _started = true;
+
+  WiFi.setTimeout(0);                     // begin() only starts the association
+  startAttempt();
+}
+
+void WifiConnection::startAttempt() {
+
+  eventLog.log(LOG_WIFI_CONNECTING, _failedAttempts);
+  WiFi.setHostname(_hostname);            // Use this host name in the DHCP registration
+  WiFi.begin(_ssid, _password);
+  _state = WIFI_CONNECTING;
+  _stateSince_ms = millis();
+}
+
+void WifiConnection::retryLater(uint32_t wait_ms) {
+
+  _wait_ms = wait_ms;
+  _state = WIFI_WAITING;
+  _stateSince_ms = millis();
+}
+
+void WifiConnection::service() {
+
+  if (!_started)
+    return;
+
+  uint32_t inState_ms = millis() - _stateSince_ms;
+
+  switch (_state) {
+
+    case WIFI_WAITING:
+      if (inState_ms >= _wait_ms)
+        startAttempt();
+      break;
+
+    case WIFI_CONNECTING: {
+      uint8_t status = WiFi.status();
+      if (status == WL_CONNECTED) {
+        if (_everConnected)
+          _reconnects++;
+        else
+          _firstConnected_ms = millis();
+        _everConnected = true;
+        _backoff_ms = WIFI_MIN_BACKOFF_ms;
+        _state = WIFI_CONNECTED;
+        _stateSince_ms = millis();
+        _onConnected();
+      } else if (status == WL_CONNECT_FAILED || inState_ms >= WIFI_CONNECT_TIMEOUT_ms) {
+        _failedAttempts++;
+        eventLog.log(LOG_WIFI_FAILED, _backoff_ms);
+        WiFi.disconnect();
+        retryLater(_backoff_ms);
+        _backoff_ms = min(_backoff_ms * 2, (uint32_t)WIFI_MAX_BACKOFF_ms);
+      }
+      break;
+    }
+
+    case WIFI_CONNECTED:
+      if (WiFi.status() != WL_CONNECTED) {
+        eventLog.log(LOG_WIFI_LOST);
+        retryLater(WIFI_MIN_BACKOFF_ms);
+      }
+      break;
+  }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file Ws2812Dma.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief WS2812B output from a SAMD21 SERCOM in SPI mode, fed by DMA.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note Nothing else in the firmware uses the DMA controller, so it is set up
+ * here the first time a string is started.
+ */
+
+#include "XmasLights.h"
+
+#if LED_OUTPUT_SPI_DMA
+
+#ifndef ARDUINO_ARCH_SAMD
+#error "LED_OUTPUT_SPI_DMA needs a SAMD21 (SERCOM and DMAC)"
+#endif
+
+#include <Arduino.h>
+#include <wiring_private.h>             // pinPeripheral()
+
+#include "Ws2812Dma.h"
+
+#define WS2812_SPI_CLOCK 2400000        // 3 SPI bits per WS2812B bit, 417 ns each
+#define DMA_CHANNELS 6               // one per SERCOM
+
+/** SPI patterns for a nibble, 1x0 for each bit, most significant bit first. */
+static const uint16_t nibblePattern[16] = {
+  0x924, 0x926, 0x934, 0x936, 0x9a4, 0x9a6, 0x9b4, 0x9b6,
+  0xd24, 0xd26, 0xd34, 0xd36, 0xda4, 0xda6, 0xdb4, 0xdb6
+};
+
+static DmacDescriptor dmaDescriptors[DMA_CHANNELS] __attribute__((aligned(16)));
+static volatile DmacDescriptor dmaWriteback[DMA_CHANNELS] __attribute__((aligned(16)));
+static bool dmacStarted = false;
+
+static void beginDmac() {
+
+  if (dmacStarted)
+    return;
+
+  PM->AHBMASK.bit.DMAC_ = 1;
+  PM->APBBMASK.bit.DMAC_ = 1;
+
+  DMAC->CTRL.bit.DMAENABLE = 0;
+  DMAC->CTRL.bit.SWRST = 1;
+  while (DMAC->CTRL.bit.SWRST)
+    ;
+
+  DMAC->BASEADDR.reg = (uint32_t)dmaDescriptors;
+  DMAC->WRBADDR.reg = (uint32_t)dmaWriteback;
+  DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xf);
+
+  dmacStarted = true;
+}
+
+/** Write one colour byte as 3 bytes of SPI data. */
+static inline uint8_t *encodeByte(uint8_t *p, uint8_t value) {
+
+  uint32_t bits = ((uint32_t)nibblePattern[value >> 4] << 12) | nibblePattern[value & 0x0f];
+  p[0] = bits >> 16;
+  p[1] = bits >> 8;
+  p[2] = bits;
+  return p + 3;
+}
+
+void Ws2812Dma::begin(const Ws2812DmaPort &port, uint8_t dmaChannel, uint8_t *buffer, uint16_t nbrLEDS) {
+
+  _dmaChannel = dmaChannel;
+  _buffer = buffer;
+  _nbrLEDS = nbrLEDS;
+
+  // Latch period at the end of the frame is never touched by the encoder.
+  memset(_buffer, 0, WS2812_DMA_BUFFER_SIZE(_nbrLEDS));
+
+  port.sercom->initSPI(port.txPad, SERCOM_RX_PAD_0, SPI_CHAR_SIZE_8_BITS, MSB_FIRST);
+  port.sercom->initSPIClock(SERCOM_SPI_MODE_0, WS2812_SPI_CLOCK);
+  port.sercom->enableSPI();
+
+  // Only the data pin is handed to the SERCOM, the clock and receive pads stay unconnected.
+  pinPeripheral(port.pin, port.pinMux);
+
+  beginDmac();
+
+  DMAC->CHID.reg = DMAC_CHID_ID(_dmaChannel);
+  DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.bit.SWRST)
+    ;
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(port.dmaTrigger) | DMAC_CHCTRLB_TRIGACT_BEAT;
+
+  // One block, the whole buffer, byte by byte into the SERCOM data register.
+  uint16_t length = WS2812_DMA_BUFFER_SIZE(_nbrLEDS);
+  DmacDescriptor &descriptor = dmaDescriptors[_dmaChannel];
+  descriptor.BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC
+                          | DMAC_BTCTRL_BLOCKACT_NOACT;
+  descriptor.BTCNT.reg = length;
+  descriptor.SRCADDR.reg = (uint32_t)_buffer + length;    // source address is the end of the block
+  descriptor.DSTADDR.reg = (uint32_t)&port.registers->SPI.DATA.reg;
+  descriptor.DESCADDR.reg = 0;
+}
+
+bool Ws2812Dma::busy() const {
+
+  // The channel disables itself when the block is done.
+  DMAC->CHID.reg = DMAC_CHID_ID(_dmaChannel);
+  return DMAC->CHCTRLA.bit.ENABLE;
+}
+
+void Ws2812Dma::encode(const CRGB *leds, uint16_t firstPixel, const ColorStage &stage) {
+
+  uint8_t *p = _buffer;
+
+  for (uint16_t i = 0; i < _nbrLEDS; i++) {
+    // WS2812B wants green, red, blue
+    uint16_t pixel = firstPixel + i;
+    p = encodeByte(p, stage.correct(leds[i].g, pixel, 1));
+    p = encodeByte(p, stage.correct(leds[i].r, pixel, 0));
+    p = encodeByte(p, stage.correct(leds[i].b, pixel, 2));
+  }
+}
+
+void Ws2812Dma::encode(const IndexedFrame &frame, uint16_t first, const ColorStage &stage) {
+
+  uint8_t encoded[INDEXED_PALETTE_SIZE][WS2812_SPI_BYTES_PER_PIXEL];
+
+  for (uint8_t i = 0; i < INDEXED_PALETTE_SIZE; i++) {
+    uint8_t *p = encoded[i];
+    p = encodeByte(p, stage.correct(frame.palette[i].g));
+    p = encodeByte(p, stage.correct(frame.palette[i].r));
+    encodeByte(p, stage.correct(frame.palette[i].b));
+  }
+
+  uint8_t *p = _buffer;
+  for (uint16_t i = 0; i < _nbrLEDS; i++, p += WS2812_SPI_BYTES_PER_PIXEL)
+    memcpy(p, encoded[frame.get(first + i)], WS2812_SPI_BYTES_PER_PIXEL);
+}
+
+void Ws2812Dma::start() {
+
+  DMAC->CHID.reg = DMAC_CHID_ID(_dmaChannel);
+  DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR | DMAC_CHINTFLAG_SUSP;
+  DMAC->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+}
+
+#endif
@@ -9,7 +9,8 @@
  * 
  * @note While it might be nice to use the flash storage on the NINA module the
  * ArduinoBLE module and WiFiNINA are difficult to use together.  Using the WiFiNINA to
- * access the filesystem disables the BLE functionality.
+ * access the filesystem disables the BLE functionality, so the settings are kept in
+ * the SAMD21's own flash instead (see Settings.h).
  * 
  */
 
@@ -20,340 +21,236 @@
 #include <FastLED.h>
 
 #include "secrets.h"
-
-/** Global defaults */
-#define CANDY_STRIPE_WIDTH 5
-#define TRAIN_CAR_LENGTH 5
-#define HOSTNAME "Library_XmasLights"
-#define NUMBER_OF_LIGHTS 150
-#define SECONDS_BETWEEN_EFFECTS 5
-#define DATA_PIN 3
-#define LED_BRIGHTNESS 64
-#define MAX_POWER_mW 5000
-
-#define MAX_DEBUG_BUFF 256
-#define LOG(...) \
-{ \
-  char _buff[MAX_DEBUG_BUFF]; \
-  snprintf(_buff, MAX_DEBUG_BUFF, __VA_ARGS__); \
-  Serial.print(_buff); \
-}
-
-
-CRGBArray<NUMBER_OF_LIGHTS> leds;
-
-int currentEffectNbr = 0;
-const int nbrOfEffects = 7;
-
-/** Web server including mDNS support */
+#include "XmasLights.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+#include "TaskScheduler.h"
+#include "WifiConnection.h"
+#include "StreamInput.h"
+#include "ShowClock.h"
+#include "ShowSync.h"
+#include "EventLog.h"
+#include "FastRandom.h"
+#include "PixelOps.h"
+#include "PowerTelemetry.h"
+#include "LedOutput.h"
+#include "Effects.h"
+#include "Settings.h"
+#include "WebServer.h"
+#include "Benchmark.h"
+
+/** mDNS support so the controllers can be found on the network */
 WiFiUDP udp;
 MDNS mdns(udp);
-WiFiServer server(80);                        // Our WiFi server listens on port 80
-
-
-/** Comet */
-void comet(unsigned int nbrOfLEDS, HSVHue cometHue = HUE_RED) {
-
-  const int cometSize = 10;
-  static int iDirection = 1;
-  static int iPos = 0;
-  const int fadeAmt = 64;
-
-  iPos += iDirection;
-
-  if (iPos == (nbrOfLEDS - cometSize) || iPos == 0)
-    iDirection *= -1;
-
-  for (int i = 0; i < cometSize; i++)
-    leds[iPos + 1].setHue(cometHue);
 
-  for (int j = 0; j < nbrOfLEDS; j++)
-    if (random(2) == 1)
-      leds[j] = leds[j].fadeToBlackBy(fadeAmt);
+#if LOG_UDP
+WiFiUDP logUdp;
+#endif
 
+/** Frames run at a steady rate whatever the effect, and renderEffect() only
+ * steps it when a step on the show clock's grid is due.  Frames at the
+ * effect's own pace would fall anywhere on that grid and show each step up to
+ * a whole interval late.  Dithering needs every frame it can get.
+ */
+FrameScheduler frameScheduler(1000000UL / (LED_DITHER ? DITHER_FRAMES_PER_SECOND : FRAMES_PER_SECOND));
+FrameProfiler frameProfiler;
+TaskScheduler taskScheduler(frameScheduler);
+PowerTelemetry powerTelemetry(LED_BRIGHTNESS, MAX_POWER_mW);
+void onWifiConnected();
+WifiConnection wifiConnection(onWifiConnected);
+StreamInput streamInput;
+ShowSync showSync;
+
+static uint32_t nextDiscovery_ms = 0;
+
+/** The effect due now on the show clock, in the order from the settings. */
+uint8_t scheduledEffect() {
+  uint32_t slot = showClock.now_ms() / (SECONDS_BETWEEN_EFFECTS * 1000UL);
+  const SettingsBlock &current = settings.current();
+  if (current.effectCount > 0)
+    return current.effectOrder[slot % current.effectCount];
+  return slot % effectCount();
 }
 
-/** Sparkle  */
-void sparkle(unsigned int nbrOfLEDS) {
-
-  static const unsigned int nbrOfColors = 6;
-
-  static const CRGB sparkleColors [nbrOfColors] =
-  {
-    CRGB::Red,
-    CRGB::Blue,
-    CRGB::Purple,
-    CRGB::Black,
-    CRGB::Green,
-    CRGB::Orange
-  };
-
-  EVERY_N_MILLISECONDS(750) {
-    for (int i = 0; i < nbrOfLEDS; i++) 
-      leds[i] = sparkleColors[random(nbrOfColors)];
-  }
+/** Background tasks, run by taskScheduler in whatever time is left over in each frame. */
+void serviceOutputTask() {
+  serviceLedOutput();                 // start a frame that was waiting for the backend
 }
 
-/** Twinkle stars */
-void twinkleStar(unsigned int nbrOfLEDS) {
-
-  static const unsigned int nbrOfColors = 5;
+void serviceMdnsTask() {
+  if (wifiConnection.state() != WIFI_CONNECTED)
+    return;
 
-  static const CRGB twinkleColors [nbrOfColors] =
-  {
-    CRGB::Red,
-    CRGB::Blue,
-    CRGB::Purple,
-    CRGB::Green,
-    CRGB::Orange
-  };
+  mdns.run();                         // allow any mDNS pending processing
 
-  static unsigned int passCount = 0;
-
-  EVERY_N_MILLISECONDS(200) {
-    passCount++;
-
-    if (passCount == nbrOfLEDS / 4) 
-    {
-      passCount = 0;
-      FastLED.clear(false);
-    }
-    
-    leds[random(nbrOfLEDS)] = twinkleColors[random(nbrOfColors)];
+  // Look for the other controllers now and then, answers come to peerFound().
+  if (SHOW_SYNC && !mdns.isDiscoveringService() && (int32_t)(millis() - nextDiscovery_ms) >= 0) {
+    nextDiscovery_ms = millis() + SYNC_DISCOVERY_INTERVAL_ms;
+    mdns.startDiscoveringService("_http", MDNSServiceTCP, SYNC_DISCOVERY_TIMEOUT_ms);
   }
-
 }
 
-/** Green and Red Train */
-void train(unsigned int nbrLEDS, unsigned int trainLength = 10) {
-
-  static int offset = 0;      // train position, advanced each call
-
-  EVERY_N_MILLISECONDS(100) {
-    FastLED.clear();
-    for (int j = 0; j < trainLength; j++) {
-      if ((j + offset) < nbrLEDS) {
-        leds[j + offset] = CRGB::DarkRed;
-      }
-      if ((j + trainLength + offset) < nbrLEDS) {
-        leds[j + trainLength + offset] = CRGB::DarkGreen;
-      }
-    }
-    
-    offset = (offset + 1) % nbrLEDS;
-  }
+void serviceSyncTask() {
+  if (wifiConnection.state() == WIFI_CONNECTED)
+    showSync.poll();
 }
 
-/** Rotating candy cane - move the candy cane one step everytime we're called 
- * 
- * @note While safe to call with any width strip, to avoid artifacts the
- * nbrOfLEDS should be divisible by 2 * stripWidth.
-*/
-void candyCane(unsigned int nbrLEDS, unsigned int stripeWidth = CANDY_STRIPE_WIDTH, CRGB stripeColor = CRGB::Red) {
-
-  static int offset = 0;
-
-  EVERY_N_MILLISECONDS(500) {
-    // Fill all with background color - white
-    fill_solid(leds, nbrLEDS, CRGB::White);
-    
-    // Draw the red stripes - compute the number of stripes
-    for (int i = 0; i < (nbrLEDS / stripeWidth); i += 2) {
-      // Draw each strip 2 strip widths apart.
-      for (int j = i * stripeWidth; j < min(((i * stripeWidth) + stripeWidth), nbrLEDS); j++) {
-        // Serial.print(j); Serial.print(",");
-        leds[(j + offset) % nbrLEDS] = stripeColor;
-      }
-    }
-
-    offset = (offset + 1) % nbrLEDS;
-  }
+void serviceWebTask() {
+  if (wifiConnection.state() == WIFI_CONNECTED)
+    processAnyWebRequests();          // Check if we have any requests and handle them.
 }
 
-/** Rotating American Flag */
-void redWhiteBlue(unsigned int nbrLEDS, unsigned int stripeWidth = 5) {
-
-  static int offset = 0;
-
-  EVERY_N_MILLISECONDS(500) {
-    
-    FastLED.clear(false);
-
-    for (int i = 0; i < nbrLEDS; i++) {
-      switch ((i % (3 * stripeWidth)) / stripeWidth) {
-        case 0:
-          leds[(i + offset) % nbrLEDS] = CRGB::DarkBlue;
-          break;
-        case 1:
-          leds[(i + offset) % nbrLEDS] = CRGB::White;
-          break;
-        case 2:
-          leds[(i + offset) % nbrLEDS] = CRGB::DarkRed;
-          break;
-      }
-    }
-    
-    offset = (offset + 1) % nbrLEDS;
-  }
+void serviceStreamTask() {
+  if (wifiConnection.state() == WIFI_CONNECTED)
+    streamInput.poll();
 }
 
-/** random green and red */
-void randomGreenAndRed(unsigned int nbrLEDS) {
-
-  EVERY_N_MILLISECONDS(500) {
-    for (int i = 0; i < nbrLEDS; i++) {
-      leds[i] = random(10) > 5 ? CRGB::DarkRed : CRGB::DarkGreen;
-    }
-  }
+void serviceWifiTask() {
+  wifiConnection.service();
 }
 
-void printWifiStatus() {
-  // print the SSID of the network you're attached to:
-  Serial.print("SSID: ");
-  Serial.println(WiFi.SSID());
-
-  // print your board's IP address:
-  IPAddress ip = WiFi.localIP();
-  Serial.print("IP Address: ");
-  Serial.println(ip);
-
-  // print the received signal strength:
-  long rssi = WiFi.RSSI();
-  Serial.print("signal strength (RSSI):");
-  Serial.print(rssi);
-  Serial.println(" dBm");
+void serviceLogTask() {
+#if LOG_UDP
+  if (wifiConnection.state() == WIFI_CONNECTED)
+    eventLog.drainToUdp(logUdp, WiFi.localIP() | ~(uint32_t)WiFi.subnetMask());
+#else
+  eventLog.drainToSerial();
+#endif
 }
 
-/** Respond to can web client connects and refresh the web status page. */
-void processAnyWebRequests() {
-
-  WiFiClient client = server.available();
-  if (client) {
-    // an HTTP request ends with a blank line
-    bool current_line_is_blank = true;
-    while (client.connected()) {
-      if (client.available()) {
-        char c = client.read();
-        // if we've gotten to the end of the line (received a newline
-        // character) and the line is blank, the HTTP request has ended,
-        // so we can send a reply
-        if (c == '\n' && current_line_is_blank) {
-          // send a standard HTTP response header
-          client.println(F("HTTP/1.1 200 OK"));
-          client.println(F("Content-Type: text/html"));
-          client.println("Connection: close");  // the connection will be closed after completion of the response
-          client.println("Refresh: 5");  // refresh the page automatically every 5 sec
-          client.println();
-
-          client.println(F("<!DOCTYPE HTML>"));
-          client.println(F("<html>"));
-          client.print(F("<h1>"));
-          client.print(HOSTNAME);
-          client.println(F("</h1>"));
-          client.println("<h2>LED Status</h2>");
-          client.print(F("Power Draw =  "));
-          client.print(calculate_unscaled_power_mW(leds, NUMBER_OF_LIGHTS) * ((float) LED_BRIGHTNESS / 255.0));
-          client.println(F(" mW"));
-          client.println(F("<br />"));
-          client.print(F("FPS = "));
-          client.println(FastLED.getFPS());
-          client.println(F("<br />"));
-          client.print(F("Effect Number = "));
-          client.println(currentEffectNbr);
-          client.println(F("</html>"));
-
-          break;
-        }
-        if (c == '\n') {
-          // we're starting a new line
-          current_line_is_blank = true;
-        } else if (c != '\r') {
-          // we've gotten a character on the current line
-          current_line_is_blank = false;
-        }
-      }
-    }
-    
-    // give the web browser time to receive the data
-    delay(1);
-    client.stop();
-    }
+/** An http service found by mDNS, each of the other controllers is one. */
+void peerFound(const char *type, MDNSServiceProtocol proto, const char *name, IPAddress ip,
+               unsigned short port, const char *txtContent) {
+  if (name && strncmp(name, SYNC_SERVICE_NAME, strlen(SYNC_SERVICE_NAME)) == 0)
+    showSync.addPeer(ip);
 }
 
+/** (Re)start everything that sits on the network, each time Wi-Fi comes up. */
+void onWifiConnected() {
 
-void setup() {
+  eventLog.log(LOG_WIFI_CONNECTED, (uint32_t)WiFi.localIP(), WiFi.RSSI());
 
-  Serial.begin(115200);
-  delay(3000);
+  // start the web server
+  beginWebServer();
 
-  pinMode(DATA_PIN, OUTPUT);
-  pinMode(LED_BUILTIN, OUTPUT);
+  // Register our services via mDNS
+  udp.stop();                         // the previous connection's socket, if any
+  mdns.begin(WiFi.localIP(), settings.current().hostname);
+  mdns.removeAllServiceRecords();
+  mdns.addServiceRecord("XmasLights_controller._http", 80, MDNSServiceTCP);
 
-  WiFi.setHostname(HOSTNAME);             // Use this host name in the DHCP registration
+  streamInput.begin();
 
-  while (WiFi.status() != WL_CONNECTED)
-  {
-    Serial.print("Attempting to connect to WiFi: ");
-    Serial.println(WIFI_SSID);
-    WiFi.begin(WIFI_SSID, WIFI_PWD);
-    delay(10000); 
+  if (SHOW_SYNC) {
+    mdns.setServiceFoundCallback(peerFound);
+    nextDiscovery_ms = millis();
+    showSync.begin(WiFi.localIP());
   }
+}
 
-  delay(5000);
+void setup() {
 
-  printWifiStatus();
+  Serial.begin(115200);
 
-  // start the web server
-  server.begin();
+#if PIXELOPS_BENCHMARK || BENCHMARK_MODE
+  delay(3000);                          // time to open the serial monitor
+#endif
 
-  // Register our services via mDNS
-  mdns.begin(WiFi.localIP(), HOSTNAME);
-  mdns.addServiceRecord("XmasLights_controller._http", 80, MDNSServiceTCP);
+#if PIXELOPS_BENCHMARK
+  benchmarkPixelOps();
+#endif
 
-  FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUMBER_OF_LIGHTS);
-  FastLED.setMaxPowerInMilliWatts(MAX_POWER_mW);
-  set_max_power_indicator_LED(LED_BUILTIN);
+#if BENCHMARK_MODE
+  // Nothing but the LEDs, so the numbers aren't disturbed by the network.
+  beginLedOutput();
+  runBenchmarks();
+  return;
+#endif
 
-  FastLED.setBrightness(LED_BRIGHTNESS);
+  pinMode(DATA_PIN, OUTPUT);
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  // Saved settings over the build's defaults, read from flash this once.
+  settings.begin();
+  applySettings();
+
+  if (RANDOM_SEED)
+    fastRandom.setSeed(RANDOM_SEED);
+  else
+    fastRandom.seedFromNoise();
+
+  // Lights first, the network comes up behind them.
+  beginLedOutput();
+  selectEffect(scheduledEffect());
+  eventLog.log(LOG_STARTED, NUMBER_OF_LIGHTS, LED_STRING_COUNT);
+
+  // Brightness and power limiting are applied per frame from the power telemetry.
+  powerTelemetry.setIndicatorPin(LED_BUILTIN);
+
+  // In priority order, after the frame itself.
+  taskScheduler.addTask("output", serviceOutputTask, TASK_OUTPUT_SLICE_us, 0, PROFILE_SHOW);
+  taskScheduler.addTask("stream", serviceStreamTask, TASK_STREAM_SLICE_us, 0, PROFILE_STREAM);
+  if (SHOW_SYNC)
+    taskScheduler.addTask("sync", serviceSyncTask, TASK_SYNC_SLICE_us, 0, PROFILE_SYNC);
+  taskScheduler.addTask("mdns", serviceMdnsTask, TASK_MDNS_SLICE_us, 0, PROFILE_MDNS);
+  taskScheduler.addTask("web", serviceWebTask, HTTP_POLL_BUDGET_us, 0, PROFILE_WEB);
+  taskScheduler.addTask("wifi", serviceWifiTask, TASK_WIFI_SLICE_us, WIFI_CHECK_INTERVAL_ms, PROFILE_WIFI);
+  taskScheduler.addTask("log", serviceLogTask, TASK_LOG_SLICE_us, 0, PROFILE_LOG);
+
+  wifiConnection.begin(WIFI_SSID, WIFI_PWD, settings.current().hostname);
 }
 
 void loop() {
 
-  mdns.run();     // allow any mDNS pending processing
-
-  switch(currentEffectNbr) {
-    case 0:
-      candyCane(NUMBER_OF_LIGHTS);
-      break;
-    case 1:
-      twinkleStar(NUMBER_OF_LIGHTS);
-      break;
-    case 2:
-      comet(NUMBER_OF_LIGHTS, HUE_ORANGE);
-      break;
-    case 3:
-      train(NUMBER_OF_LIGHTS);
-      break;
-    case 4:
-      sparkle(NUMBER_OF_LIGHTS);
-      break;
-    case 5: 
-      redWhiteBlue(NUMBER_OF_LIGHTS);
-      break;
-    case 6:
-      randomGreenAndRed(NUMBER_OF_LIGHTS);
-      break;
+#if BENCHMARK_MODE
+  EVERY_N_SECONDS(BENCHMARK_REPEAT_s) {
+    runBenchmarks();
   }
-
-  FastLED.show();
-
-  processAnyWebRequests();            // Check if we have any requests and handle them.
-
-  EVERY_N_SECONDS(SECONDS_BETWEEN_EFFECTS) {
-    currentEffectNbr = (currentEffectNbr + 1) % nbrOfEffects;
-    FastLED.clear(false);
+  return;
+#endif
+
+  static bool wasStreaming = false;
+
+  frameScheduler.beginFrame();
+  frameProfiler.startFrame();
+  uint8_t effectShown = currentEffectNbr;
+
+  // A sequencer streaming to us takes over from the effects.
+  // A crossfade it cuts into is ended, the streamed frame isn't blended with it.
+  bool streaming = streamInput.active();
+  if (streaming) {
+    endTransition();
+    streamInput.takeFrame();
+  } else
+    renderEffect(leds, NUMBER_OF_LIGHTS);
+  frameProfiler.lap(PROFILE_RENDER);
+
+  showFrame();
+  frameProfiler.lap(PROFILE_SHOW);
+
+  // Effects change on the show clock, at the same moment on every controller.
+  uint8_t scheduled = scheduledEffect();
+  if (!streaming && scheduled != currentEffectNbr) {
+#if LED_INDEXED_FRAME
+    transitionToEffect(scheduled, leds);
+#else
+    transitionToEffect(scheduled, leds, NUMBER_OF_LIGHTS);
+#endif
+  }
+  if (streaming != wasStreaming) {
+    if (streaming)
+      eventLog.log(LOG_STREAM_STARTED);
+    else
+      eventLog.log(LOG_STREAM_STOPPED, streamInput.packets(), streamInput.lostPackets());
   }
+  wasStreaming = streaming;
+  frameProfiler.lap(PROFILE_RENDER);
 
-  delay(50);
+  // Give the rest of the frame to the background tasks instead of sleeping it away.
+  taskScheduler.runIdle(NETWORK_POLL_RESERVE_us);
 
+  if (frameScheduler.endFrame())
+    eventLog.log(LOG_FRAME_OVERRUN, frameScheduler.lastFrame_us(), frameScheduler.framePeriod_us());
+  frameProfiler.lap(PROFILE_IDLE);
+  frameProfiler.endFrame(effectShown);
 }
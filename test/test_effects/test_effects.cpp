@@ -0,0 +1,285 @@
+/**
+ * @file test_effects.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Golden frames and timings for the effect kernels, run on the build host.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * pio test -e native
+ *
+ * Every effect is run for BENCH_FRAMES steps from a fixed seed at each string
+ * length.  The frames are checksummed against the golden values below, and
+ * the time per step is printed.  Host timings are only good for spotting a
+ * regression between runs, the device numbers come from the nano_33_iot_bench
+ * environment.
+ *
+ * When a change to an effect is meant to change its frames, print the new
+ * checksums with -D PRINT_GOLDEN and paste them in.
+ */
+
+#include <chrono>
+#include <math.h>
+#include <unity.h>
+
+#include "XmasLights.h"
+#include "FastRandom.h"
+#include "Effects.h"
+#include "PowerTelemetry.h"
+
+#define BENCH_FRAMES 400
+#define BENCH_SEED 1
+#define BENCH_MAX_LEDS 2400
+
+static const uint16_t benchSizes[] = { 150, 600, BENCH_MAX_LEDS };
+static const uint8_t nbrOfSizes = sizeof(benchSizes) / sizeof(benchSizes[0]);
+
+/** FNV-1a over all BENCH_FRAMES frames, by effect and then benchSizes. */
+static const uint32_t goldenChecksums[][nbrOfSizes] = {
+  { 0xfb600f45, 0xb04937c5, 0xaa6925c5 },   // Candy Cane
+  { 0xd56d8728, 0x81159e26, 0xbb1a89e4 },   // Twinkle Star
+  { 0x831d9c89, 0x93b6aed1, 0x1df8325c },   // Comet
+  { 0x867bce4d, 0x45965e05, 0xc2d20e05 },   // Train
+  { 0x3e6e52aa, 0x242ec888, 0x5e5c72e8 },   // Sparkle
+  { 0x02a4231d, 0x399d50e5, 0x3422f885 },   // Red White and Blue
+  { 0x8564bb81, 0xd7f6da93, 0x1f47e791 },   // Random Green and Red
+};
+
+alignas(4) static CRGB frame[BENCH_MAX_LEDS];
+
+/** Stand ins for LedOutput, the effects draw into frame rather than leds. */
+void markFrameDirty(uint32_t) {}
+void clearFrame() {}
+
+static uint32_t checksum(uint32_t hash, const CRGB *leds, uint16_t nbrLEDS) {
+  const uint8_t *p = (const uint8_t *)leds;
+  for (uint32_t i = 0; i < nbrLEDS * sizeof(CRGB); i++) {
+    hash ^= p[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/** Run an effect from its first step, returning the checksum of every frame. */
+static uint32_t runEffect(const Effect &effect, uint16_t nbrLEDS, uint32_t *elapsed_ns) {
+
+  fastRandom.setSeed(BENCH_SEED);
+  effect.reset();
+  fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+
+  uint32_t hash = 2166136261u;
+  uint64_t total_ns = 0;
+
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    auto started = std::chrono::steady_clock::now();
+    effect.render(frame, nbrLEDS);
+    total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+    hash = checksum(hash, frame, nbrLEDS);
+  }
+
+  *elapsed_ns = total_ns / BENCH_FRAMES;
+  return hash;
+}
+
+static void test_golden_frames() {
+
+  TEST_ASSERT_EQUAL_UINT8(sizeof(goldenChecksums) / sizeof(goldenChecksums[0]), effectCount());
+
+  char message[96];
+  for (uint8_t e = 0; e < effectCount(); e++) {
+    const Effect &effect = getEffect(e);
+    for (uint8_t s = 0; s < nbrOfSizes; s++) {
+      uint32_t ns;
+      uint32_t hash = runEffect(effect, benchSizes[s], &ns);
+      snprintf(message, sizeof(message), "%-22s %5u LEDs %8lu ns/frame  checksum 0x%08lx",
+               effect.name, benchSizes[s], (unsigned long)ns, (unsigned long)hash);
+      TEST_MESSAGE(message);
+#ifndef PRINT_GOLDEN
+      TEST_ASSERT_EQUAL_HEX32_MESSAGE(goldenChecksums[e][s], hash, effect.name);
+#endif
+    }
+  }
+}
+
+/** The comet's head is all cometSize pixels, still lit after one step and its random fade. */
+static void test_comet_head_is_whole() {
+
+  for (uint8_t e = 0; e < effectCount(); e++) {
+    const Effect &effect = getEffect(e);
+    if (strcmp(effect.name, "Comet") != 0)
+      continue;
+
+    fastRandom.setSeed(BENCH_SEED);
+    effect.reset();
+    fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+    effect.render(frame, 150);
+
+    int lit = 0;
+    for (int i = 0; i < 150; i++)
+      if (frame[i] != CRGB(CRGB::Black))
+        lit++;
+    TEST_ASSERT_EQUAL_INT(10, lit);
+    return;
+  }
+  TEST_FAIL_MESSAGE("no Comet effect registered");
+}
+
+/** Rotating effects come back to their first frame after one period. */
+static void test_candy_cane_period() {
+
+  const Effect &effect = getEffect(0);
+  TEST_ASSERT_EQUAL_STRING("Candy Cane", effect.name);
+
+  static CRGB first[150];
+  effect.reset();
+  effect.render(frame, 150);
+  memcpy(first, frame, sizeof(first));
+  for (int step = 0; step < 2 * CANDY_STRIPE_WIDTH; step++)
+    effect.render(frame, 150);
+  TEST_ASSERT_EQUAL_MEMORY(first, frame, sizeof(first));
+}
+
+/** The number of the effect with this name, effectCount() if there isn't one. */
+static uint8_t effectNamed(const char *name) {
+  uint8_t e = 0;
+  while (e < effectCount() && strcmp(getEffect(e).name, name) != 0)
+    e++;
+  return e;
+}
+
+/** Checksums of an effect's first steps, run on its own from its first step. */
+static void effectSteps(const Effect &effect, uint16_t nbrLEDS, uint32_t *steps, int count) {
+  effect.reset();
+  fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+  for (int k = 0; k < count; k++) {
+    effect.render(frame, nbrLEDS);
+    steps[k] = checksum(2166136261u, frame, nbrLEDS);
+  }
+}
+
+/** Matches a frame against an effect's steps, it may only stay put or move on to the next one. */
+static bool followsSteps(const CRGB *leds, const uint32_t *steps, int count, int &step) {
+  uint32_t hash = checksum(2166136261u, leds, NUMBER_OF_LIGHTS);
+  if (step >= 0 && hash == steps[step])
+    return true;
+  return ++step < count && hash == steps[step];
+}
+
+/** Two baked effects crossfading both run, each from its own position. */
+static void test_crossfade_baked() {
+
+  static const int count = 64;
+  static uint32_t trainSteps[count], candySteps[count];
+  uint8_t train = effectNamed("Train");
+  uint8_t candy = effectNamed("Candy Cane");
+  TEST_ASSERT_TRUE(train < effectCount() && candy < effectCount());
+  effectSteps(getEffect(train), NUMBER_OF_LIGHTS, trainSteps, count);
+  effectSteps(getEffect(candy), NUMBER_OF_LIGHTS, candySteps, count);
+
+  selectEffect(train);
+  fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+  int trainStep = -1, candyStep = -1;
+  for (int i = 0; i < 200; i++) {
+    advanceMillis(10);
+    renderEffect(frame, NUMBER_OF_LIGHTS);
+    TEST_ASSERT_TRUE(followsSteps(frame, trainSteps, count, trainStep));
+  }
+
+  transitionToEffect(candy, frame, NUMBER_OF_LIGHTS);
+  int fadeStart = trainStep;
+  while (transitionFrame() != NULL) {
+    advanceMillis(10);
+    renderEffect(frame, NUMBER_OF_LIGHTS);
+    TEST_ASSERT_TRUE(followsSteps(frame, candySteps, count, candyStep));
+    if (transitionFrame() != NULL)
+      TEST_ASSERT_TRUE(followsSteps(transitionFrame(), trainSteps, count, trainStep));
+  }
+
+  TEST_ASSERT_TRUE(candyStep >= 1);
+  TEST_ASSERT_TRUE(trainStep - fadeStart >= EFFECT_TRANSITION_ms / 100 - 1);
+}
+
+/** A stream taking over mid crossfade ends it, though renderEffect() is no longer called. */
+static void test_stream_ends_transition() {
+
+  selectEffect(0);
+  fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+  advanceMillis(10);
+  renderEffect(frame, NUMBER_OF_LIGHTS);
+  transitionToEffect(1, frame, NUMBER_OF_LIGHTS);
+  TEST_ASSERT_TRUE(transitionFrame() != NULL);
+
+  // The stream's frames replace renderEffect(), as in loop().
+  advanceMillis(EFFECT_TRANSITION_ms + 10);
+  TEST_ASSERT_TRUE(transitionFrame() != NULL);
+  endTransition();
+  TEST_ASSERT_TRUE(transitionFrame() == NULL);
+  TEST_ASSERT_EQUAL_UINT32(256, transitionWeight());
+}
+
+/** A power model is the most any step draws - never less than a frame, and no more than the brightest. */
+static void test_power_models() {
+
+  static const uint16_t sizes[] = { 150, 153 };
+
+  for (uint8_t e = 0; e < effectCount(); e++) {
+    const Effect &effect = getEffect(e);
+    if (effect.power_mW == NULL)
+      continue;
+
+    for (uint16_t nbrLEDS : sizes) {
+      uint32_t model_mW = effect.power_mW(nbrLEDS);
+      uint32_t most_mW = 0;
+
+      effect.reset();
+      fill_solid(frame, BENCH_MAX_LEDS, CRGB::Black);
+      for (int step = 0; step < 2 * nbrLEDS; step++) {
+        effect.render(frame, nbrLEDS);
+        PixelPower power;
+        for (uint16_t i = 0; i < nbrLEDS; i++)
+          power.add(frame[i]);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(model_mW, power.unscaled_mW(), effect.name);
+        most_mW = max(most_mW, power.unscaled_mW());
+      }
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(model_mW, most_mW, effect.name);
+    }
+  }
+}
+
+/** Frames are costed as the LEDs see them, through the gamma curve. */
+static void test_power_after_gamma() {
+
+  static const uint8_t levels[] = { 0, 32, 128, 200, 255 };
+
+  for (uint8_t level : levels) {
+    fill_solid(frame, 150, CRGB(level, level / 2, 255 - level));
+
+    PowerTelemetry power(255, UINT32_MAX);
+    power.update(frame, 150);
+
+    // The same frame gamma corrected in floating point, at 255/256 brightness as the limiter scales it.
+    double red = pow(level / 255.0, LED_GAMMA), green = pow((level / 2) / 255.0, LED_GAMMA);
+    double blue = pow((255 - level) / 255.0, LED_GAMMA);
+    double reference_mW = (150 * (red * POWER_RED_mW + green * POWER_GREEN_mW + blue * POWER_BLUE_mW + POWER_DARK_mW)
+                           + POWER_MCU_mW) * 255 / 256;
+
+    char message[64];
+    snprintf(message, sizeof(message), "level %u: %lu mW, reference %.0f mW",
+             level, (unsigned long)power.frame_mW(), reference_mW);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(fabs(power.frame_mW() - reference_mW) <= 2 + reference_mW / 200, message);
+  }
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_comet_head_is_whole);
+  RUN_TEST(test_candy_cane_period);
+  RUN_TEST(test_power_models);
+  RUN_TEST(test_power_after_gamma);
+  RUN_TEST(test_crossfade_baked);
+  RUN_TEST(test_stream_ends_transition);
+  RUN_TEST(test_golden_frames);
+  return UNITY_END();
+}
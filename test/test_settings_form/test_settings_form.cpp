@@ -0,0 +1,71 @@
+/**
+ * @file test_settings_form.cpp
+ * @author Thomas J. Petz, Jr. (tom@tjpetz.com)
+ * @brief Settings forms parsed as the clients that send them encode them, run on the build host.
+ * @version 0.1
+ * @date 2026-10-14
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * pio test -e native
+ */
+
+#include <unity.h>
+
+#include "SettingsForm.h"
+
+/** Stand ins for LedOutput, the native build links the effects in too. */
+void markFrameDirty(uint32_t) {}
+void clearFrame() {}
+
+static SettingsBlock blankBlock() {
+  SettingsBlock block;
+  memset(&block, 0, sizeof(block));
+  return block;
+}
+
+/** The commas of effect_order as a form post or URLSearchParams escapes them. */
+static void test_encoded_effect_order() {
+
+  static const uint8_t expected[] = { 0, 2, 4 };
+  SettingsBlock block = blankBlock();
+
+  TEST_ASSERT_TRUE(parseSettingsForm("effect_order=0%2C2%2c4", block));
+  TEST_ASSERT_EQUAL_UINT8(3, block.effectCount);
+  TEST_ASSERT_EQUAL_MEMORY(expected, block.effectOrder, sizeof(expected));
+
+  block = blankBlock();
+  TEST_ASSERT_TRUE(parseSettingsForm("effect_order=0,2,4", block));
+  TEST_ASSERT_EQUAL_UINT8(3, block.effectCount);
+  TEST_ASSERT_EQUAL_MEMORY(expected, block.effectOrder, sizeof(expected));
+}
+
+/** '+' and %XX in any value are decoded, not taken literally. */
+static void test_decoded_values() {
+
+  SettingsBlock block = blankBlock();
+
+  TEST_ASSERT_TRUE(parseSettingsForm("hostname=Front+Porch%2D1&brightness=%39%36&max_power_mW=4000", block));
+  TEST_ASSERT_EQUAL_STRING("Front Porch-1", block.hostname);
+  TEST_ASSERT_EQUAL_UINT8(96, block.brightness);
+  TEST_ASSERT_EQUAL_UINT32(4000, block.maxPower_mW);
+}
+
+/** A broken escape, or one standing for a NUL, is refused. */
+static void test_bad_escapes() {
+
+  SettingsBlock block = blankBlock();
+
+  TEST_ASSERT_FALSE(parseSettingsForm("brightness=9%3", block));
+  TEST_ASSERT_FALSE(parseSettingsForm("brightness=%G6", block));
+  TEST_ASSERT_FALSE(parseSettingsForm("hostname=Porch%00", block));
+  TEST_ASSERT_FALSE(parseSettingsForm("effect_order=0%2C%2C4", block));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_encoded_effect_order);
+  RUN_TEST(test_decoded_values);
+  RUN_TEST(test_bad_escapes);
+  return UNITY_END();
+}